@@ -0,0 +1,85 @@
+#include <cstring>
+#include "analizador.h"
+#include "lexersimd.h"
+#include "plegado.h"
+#include "pool.h"
+#include "tokenbuffer.h"
+
+bool conPilaSuficiente(ParserContext& ctx, const OpcionesAnalisis& opciones,
+                       const std::function<void()>& analizar) {
+    ctx.profundidadMaxima = opciones.profundidadMaxima;
+    ctx.maximoErrores = opciones.maximoErrores;
+    size_t pila = pilaNecesaria(ctx);
+    if (pila <= PILA_SEGURA) {
+        analizar();
+        return true;
+    }
+    if (ejecutarConPila(pila + PILA_SEGURA / 2, analizar)) {
+        return true;
+    }
+    ctx.profundidadMaxima = (int)(PILA_SEGURA / BYTES_PILA_POR_NIVEL);
+    analizar();
+    return false;
+}
+
+bool analizarContexto(ParserContext& ctx, const OpcionesAnalisis& opciones,
+                      EstadisticasParalelo* paralelo) {
+    ctx.maximoErrores = opciones.maximoErrores;
+    if (opciones.parserTabla) {
+        iniciarParser(ctx);
+        programaLL1(ctx);
+        return true;
+    }
+    ctx.profundidadMaxima = opciones.profundidadMaxima;
+    if (opciones.hilosParser > 1 && ctx.flujo == nullptr && pilaNecesaria(ctx) <= PILA_SEGURA) {
+        programaParalelo(ctx, opciones.hilosParser, paralelo);
+        return true;
+    }
+    return conPilaSuficiente(ctx, opciones, [&ctx]() {
+        iniciarParser(ctx);
+        programa(ctx);
+    });
+}
+
+bool analizarSemantica(ParserContext& ctx, Semantica& semantica,
+                       const OpcionesAnalisis& opciones) {
+    if (!opciones.semantico || tieneErrores(ctx)) {
+        return true;
+    }
+    if (!verificarPrograma(ctx, semantica, opciones.hilosSemantico)) {
+        return false;
+    }
+    return !opciones.plegar || plegarConstantes(ctx, semantica);
+}
+
+bool analizar(Analisis& analisis, const char* datos, size_t longitud,
+              const OpcionesAnalisis& opciones) {
+    // El lexer escribe sobre la fuente y los tokens la referencian: se
+    // analiza una copia propia. resize conserva la capacidad de antes.
+    std::vector<char>& texto = analisis.texto;
+    texto.resize(longitud + 2);
+    if (longitud > 0) {
+        memcpy(texto.data(), datos, longitud);
+    }
+    texto[longitud] = '\0';
+    texto[longitud + 1] = '\0';
+
+    ParserContext& ctx = analisis.ctx;
+    ctx.flujo = nullptr;
+    ctx.retenerAst = true;
+    ctx.interner.limpiar();
+    if (opciones.lexerSimd) {
+        tokenizarSimd(ctx.tokens, ctx.interner, texto.data(), longitud);
+    } else {
+        tokenizar(ctx.tokens, ctx.interner, texto.data(), longitud);
+    }
+    analizarContexto(ctx, opciones);
+    analizarSemantica(ctx, analisis.semantica, opciones);
+    return !tieneErrores(ctx);
+}
+
+Analisis analizar(const char* datos, size_t longitud, const OpcionesAnalisis& opciones) {
+    Analisis analisis;
+    analizar(analisis, datos, longitud, opciones);
+    return analisis;
+}
@@ -0,0 +1,85 @@
+#ifndef ANALIZADOR_H
+#define ANALIZADOR_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "parser.h"
+#include "paralelo.h"
+#include "semantico.h"
+
+// Uso del analizador como biblioteca, sobre texto en memoria: el mismo
+// analisis que hace la linea de comandos con un archivo, sin procesos ni
+// archivos de por medio.
+
+// Que lexer y que parser usar (las opciones del mismo nombre de main.cpp)
+struct OpcionesAnalisis {
+    bool lexerSimd = false;         // lexersimd.h en vez del DFA de flex
+    bool parserTabla = false;       // programaLL1 en vez del descendente recursivo
+    int profundidadMaxima = PROFUNDIDAD_MAXIMA_DEFECTO;
+    size_t maximoErrores = 0;       // 0 = sin limite
+    unsigned hilosParser = 1;       // > 1: programaParalelo con esos hilos
+    bool semantico = false;         // verificarPrograma si no hubo errores sintacticos
+    unsigned hilosSemantico = 1;    // > 1: verificarPrograma reparte las funciones en esos hilos
+    bool plegar = false;            // con semantico: plegarConstantes si no hubo errores
+};
+
+// Corre el parser elegido sobre ctx (tokens ya lexados o ctx.flujo). El de
+// tabla no usa la pila; el paralelo necesita que la pila de cualquier hilo
+// alcance. No corre las pasadas semanticas (ver analizarSemantica).
+// Devuelve false si tuvo que bajar el anidamiento permitido (ver
+// conPilaSuficiente).
+bool analizarContexto(ParserContext& ctx, const OpcionesAnalisis& opciones,
+                      EstadisticasParalelo* paralelo = nullptr);
+
+// Corre analizar, que usa el parser descendente sobre ctx. Si el
+// anidamiento permitido necesita mas pila de la que tiene cualquier hilo,
+// corre en un hilo con una pila a medida; si no se puede reservar, corre
+// aca con el anidamiento que entra en PILA_SEGURA (ctx.profundidadMaxima)
+// y devuelve false.
+bool conPilaSuficiente(ParserContext& ctx, const OpcionesAnalisis& opciones,
+                       const std::function<void()>& analizar);
+
+// Con opciones.semantico y un arbol sin errores, las pasadas semanticas
+// sobre ctx (que tiene que tener los tokens completos y el arbol retenido)
+// y, con opciones.plegar, el plegado de constantes, que modifica ctx.ast.
+// Devuelve false si las corrio y encontraron errores.
+bool analizarSemantica(ParserContext& ctx, Semantica& semantica,
+                       const OpcionesAnalisis& opciones);
+
+// Resultado de analizar: los tokens (ctx.tokens.cantidad()), el arbol
+// (ctx.ast, con los simbolos en ctx.interner), los errores (ctx.errores;
+// el texto con escribirMensaje o mostrarErrores) y, con
+// OpcionesAnalisis::semantico, lo que calcularon las pasadas semanticas.
+// Es dueno de una copia de la entrada, a la que apuntan los tokens y los
+// mensajes.
+// Para analizar muchos textos conviene reusar el mismo Analisis: cada
+// llamada pisa el resultado anterior pero conserva la memoria ya reservada
+// (texto, tokens, nodos, errores, simbolos), asi que una vez que llego al
+// tamano de las entradas no vuelve a pedir memoria. No se puede copiar (los
+// tokens apuntan a su texto); si mover.
+struct Analisis {
+    std::vector<char> texto;        // la entrada seguida de dos '\0' (ver fuente.h)
+    ParserContext ctx;
+    Semantica semantica;
+
+    Analisis() = default;
+    Analisis(const Analisis&) = delete;
+    Analisis& operator=(const Analisis&) = delete;
+    Analisis(Analisis&&) = default;
+    Analisis& operator=(Analisis&&) = default;
+};
+
+// Analiza los longitud bytes de datos (no hace falta que terminen en '\0')
+// y deja el resultado en analisis. Devuelve true si no hubo errores.
+// Supone, como la linea de comandos, que el hilo que llama tiene al menos
+// PILA_SEGURA de pila. Varios hilos pueden analizar a la vez, cada uno con
+// su Analisis.
+bool analizar(Analisis& analisis, const char* datos, size_t longitud,
+              const OpcionesAnalisis& opciones = OpcionesAnalisis());
+
+// Lo mismo en un Analisis nuevo
+Analisis analizar(const char* datos, size_t longitud,
+                  const OpcionesAnalisis& opciones = OpcionesAnalisis());
+
+#endif
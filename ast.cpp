@@ -0,0 +1,130 @@
+#include <string>
+#include "ast.h"
+#include "interner.h"
+#include "parser.h"
+#include "tokens.h"
+
+void Ast::reiniciar() {
+    // Los nodos son POD: clear() no recorre nada y conserva la capacidad
+    nodos.clear();
+    hijos.clear();
+    pila.clear();
+    raiz = NODO_NULO;
+}
+
+void Ast::reservar(size_t tokens) {
+    // En el corpus sale alrededor de un nodo y un hijo cada 1.7 tokens
+    nodos.reserve(tokens * 5 / 8);
+    hijos.reserve(tokens * 5 / 8);
+}
+
+void Ast::liberarHasta(const Marca& m) {
+    nodos.resize(m.nodos);
+    hijos.resize(m.hijos);
+}
+
+NodoId Ast::crear(TipoNodo tipo, int op, uint32_t offset, uint32_t valor, size_t desde) {
+    Nodo n;
+    n.tipo = tipo;
+    n.op = (uint8_t)op;
+    n.offset = offset;
+    n.valor = valor;
+    n.primerHijo = (uint32_t)hijos.size();
+    n.cantidadHijos = (uint32_t)(pila.size() - desde);
+    hijos.insert(hijos.end(), pila.begin() + desde, pila.end());
+    pila.resize(desde);
+    nodos.push_back(n);
+    return (NodoId)(nodos.size() - 1);
+}
+
+const char* nombreNodo(TipoNodo tipo) {
+    switch (tipo) {
+        case N_PROGRAMA: return "programa";
+        case N_FUNCION: return "funcion";
+        case N_PARAMETRO: return "parametro";
+        case N_DECLVAR: return "declvar";
+        case N_TIPO: return "tipo";
+        case N_BLOQUE: return "bloque";
+        case N_IF: return "if";
+        case N_WHILE: return "while";
+        case N_RETURN: return "return";
+        case N_ATRIB: return "atrib";
+        case N_LLAMADA: return "llamada";
+        case N_VAR: return "var";
+        case N_INDEXAR: return "indexar";
+        case N_NEW: return "new";
+        case N_BINARIA: return "binaria";
+        case N_UNARIA: return "unaria";
+        case N_NUMERO: return "numero";
+        case N_STRING: return "string";
+        case N_BOOL: return "bool";
+        case N_ERROR: return "error";
+    }
+    return "?";
+}
+
+// Operadores de un caracter tal cual; el resto con el nombre del token
+static std::string textoOperador(int op) {
+    if (op > 0 && op < T_NL) {
+        return std::string(1, (char)op);
+    }
+    return nombreToken(op);
+}
+
+static void imprimirNodo(const Ast& ast, const Interner& interner, NodoId id, std::ostream& salida) {
+    const Nodo& n = ast.nodo(id);
+    salida << nombreNodo((TipoNodo)n.tipo);
+    switch (n.tipo) {
+        case N_FUNCION: case N_PARAMETRO: case N_DECLVAR: case N_LLAMADA: case N_VAR:
+        case N_STRING:
+            salida << ' ';
+            salida.write(interner.texto(n.valor), interner.longitud(n.valor));
+            break;
+        case N_TIPO:
+            salida << ' ';
+            for (uint32_t i = 0; i < n.valor; i++) salida << "[]";
+            salida << (n.op != 0 ? nombreToken(n.op) : "?");
+            break;
+        case N_BINARIA: case N_UNARIA:
+            salida << ' ' << textoOperador(n.op);
+            break;
+        case N_NUMERO:
+            salida << ' ' << (int)n.valor;
+            break;
+        case N_BOOL:
+            salida << ' ' << (n.valor ? "true" : "false");
+            break;
+    }
+    salida << '\n';
+}
+
+static const uint32_t MAX_SANGRIA = 40;
+
+void imprimirAst(const Ast& ast, const Interner& interner, std::ostream& salida) {
+    struct Pendiente {
+        NodoId id;
+        uint32_t profundidad;
+    };
+    std::vector<Pendiente> pendientes;
+    if (ast.raiz != NODO_NULO) {
+        pendientes.push_back({ast.raiz, 0});
+    }
+    while (!pendientes.empty()) {
+        Pendiente p = pendientes.back();
+        pendientes.pop_back();
+        // Mas alla de MAX_SANGRIA la sangria no crece (la salida seria
+        // cuadratica en la altura) y se indica la profundidad
+        for (uint32_t i = 0; i < p.profundidad && i < MAX_SANGRIA; i++) salida << "  ";
+        if (p.profundidad > MAX_SANGRIA) salida << '<' << p.profundidad << "> ";
+        if (p.id == NODO_NULO) {
+            salida << "(vacio)\n";
+            continue;
+        }
+        imprimirNodo(ast, interner, p.id, salida);
+        // Los hijos se apilan al reves para salir en orden
+        const Nodo& n = ast.nodo(p.id);
+        for (uint32_t i = n.cantidadHijos; i > 0; i--) {
+            pendientes.push_back({ast.hijo(p.id, i - 1), p.profundidad + 1});
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef AST_H
+#define AST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class Interner;
+
+// Indice de un nodo en Ast::nodos
+typedef uint32_t NodoId;
+const NodoId NODO_NULO = 0xFFFFFFFFu;
+
+// Clases de nodo. Entre corchetes, los hijos en orden; NODO_NULO marca una
+// parte opcional ausente (o faltante, si hubo errores sintacticos).
+enum TipoNodo : uint8_t {
+    N_PROGRAMA,     // [decl...]                        funciones y globales
+    N_FUNCION,      // [parametro..., retorno, bloque]  valor: nombre
+    N_PARAMETRO,    // [tipo]                           valor: nombre
+    N_DECLVAR,      // [tipo]                           valor: nombre (global o local)
+    N_TIPO,         // []         op: int/bool/char/string, valor: cantidad de '[]'
+    N_BLOQUE,       // [declvar..., comando...]
+    N_IF,           // [cond, bloque, {cond, bloque}, [bloque else]]  impar si hay else
+    N_WHILE,        // [cond, bloque]
+    N_RETURN,       // [exp] o []
+    N_ATRIB,        // [destino, exp]  (exp nula en 'a[i]' sin '=': error en verificarPrograma)
+    N_LLAMADA,      // [argumento...]                   valor: nombre; comando o expresion
+    N_VAR,          // []                               valor: nombre
+    N_INDEXAR,      // [arreglo, indice]
+    N_NEW,          // [tamano, tipo]
+    N_BINARIA,      // [izq, der]                       op: operador
+    N_UNARIA,       // [operando]                       op: 'not' o '-'
+    N_NUMERO,       // []                               valor: numero
+    N_STRING,       // []                               valor: SimboloId (con comillas)
+    N_BOOL,         // []                               valor: 0 o 1
+    N_ERROR         // []  expresion que no se pudo reconocer
+};
+
+// 20 bytes por nodo mas 4 por hijo. offset es el byte del token principal
+// (nombre, palabra clave u operador) en la fuente, para ubicar errores.
+struct Nodo {
+    uint8_t tipo;           // TipoNodo
+    uint8_t op;             // token: operador, tipo base o palabra clave
+    uint32_t offset;
+    uint32_t valor;
+    uint32_t primerHijo;    // indice en Ast::hijos
+    uint32_t cantidadHijos;
+};
+static_assert(sizeof(Nodo) == 20, "Nodo debe ocupar 20 bytes");
+
+// Arbol sintactico en una sola arena: los nodos se direccionan por indice y
+// los hijos de cada nodo ocupan un rango contiguo de Ast::hijos. Los hijos
+// se crean antes que el padre (el parser los va apilando en pila) y se
+// copian al crear el padre, asi que no hay un new por nodo ni punteros
+// entre nodos, y liberar todo el arbol es un solo reiniciar().
+struct Ast {
+    std::vector<Nodo> nodos;
+    std::vector<NodoId> hijos;
+    std::vector<NodoId> pila;       // hijos de los nodos en construccion
+    NodoId raiz = NODO_NULO;
+
+    // Posicion de la arena para liberar despues todo lo creado desde ahi
+    struct Marca {
+        size_t nodos;
+        size_t hijos;
+    };
+
+    size_t cantidad() const { return nodos.size(); }
+    const Nodo& nodo(NodoId id) const { return nodos[id]; }
+    NodoId hijo(NodoId id, uint32_t i) const { return hijos[nodos[id].primerHijo + i]; }
+    size_t bytes() const { return nodos.size() * sizeof(Nodo) + hijos.size() * sizeof(NodoId); }
+
+    void reiniciar();
+    // Reserva lugar para el arbol estimado de esa cantidad de tokens
+    void reservar(size_t tokens);
+    Marca marca() const { return Marca{nodos.size(), hijos.size()}; }
+    void liberarHasta(const Marca& m);
+
+    void apilar(NodoId id) { pila.push_back(id); }
+
+    // Nodo cuyos hijos son pila[desde..], que se desapilan
+    NodoId crear(TipoNodo tipo, int op, uint32_t offset, uint32_t valor, size_t desde);
+
+    // Nodos con hijos fijos, sin pasar por la pila
+    NodoId hoja(TipoNodo tipo, int op, uint32_t offset, uint32_t valor) {
+        nodos.push_back(Nodo{(uint8_t)tipo, (uint8_t)op, offset, valor, (uint32_t)hijos.size(), 0});
+        return (NodoId)(nodos.size() - 1);
+    }
+    NodoId unario(TipoNodo tipo, int op, uint32_t offset, uint32_t valor, NodoId a) {
+        nodos.push_back(Nodo{(uint8_t)tipo, (uint8_t)op, offset, valor, (uint32_t)hijos.size(), 1});
+        hijos.push_back(a);
+        return (NodoId)(nodos.size() - 1);
+    }
+    NodoId binario(TipoNodo tipo, int op, uint32_t offset, NodoId a, NodoId b) {
+        nodos.push_back(Nodo{(uint8_t)tipo, (uint8_t)op, offset, 0, (uint32_t)hijos.size(), 2});
+        hijos.push_back(a);
+        hijos.push_back(b);
+        return (NodoId)(nodos.size() - 1);
+    }
+
+    void fijarHijo(NodoId id, uint32_t i, NodoId h) { hijos[nodos[id].primerHijo + i] = h; }
+};
+
+const char* nombreNodo(TipoNodo tipo);
+
+// Vuelca el arbol con un nodo por linea, indentado por profundidad. Es
+// iterativo: una suma de un millon de terminos es un arbol de esa altura.
+void imprimirAst(const Ast& ast, const Interner& interner, std::ostream& salida);
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Cliente del modo servidor (ver servidor.h): se usa igual que ./parser,
+ * con los mismos argumentos, la misma salida y el mismo codigo de salida,
+ * pero el analisis lo hace un ./parser --servidor=ruta ya cargado. Esta en
+ * C y sin la biblioteca de C++ para que su propio arranque sea minimo.
+ *
+ *   cc -O2 -o parser-cliente cliente.c
+ *   ./parser --servidor=/tmp/parser.sock &
+ *   PARSER_SERVIDOR=/tmp/parser.sock ./parser-cliente archivo.m0
+ *
+ * Sin PARSER_SERVIDOR, o si no hay un servidor escuchando, ejecuta el
+ * ./parser que esta junto al cliente (o el del PATH) con los mismos
+ * argumentos. La diferencia con ./parser es que stdout y stderr llegan
+ * cada uno completo, no intercalados.
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static int escribirTodo(int fd, const void* datos, size_t cantidad) {
+    const char* p = (const char*)datos;
+    while (cantidad > 0) {
+        ssize_t escritos = send(fd, p, cantidad, MSG_NOSIGNAL);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) return 0;
+        p += escritos;
+        cantidad -= (size_t)escritos;
+    }
+    return 1;
+}
+
+static int leerTodo(int fd, void* datos, size_t cantidad) {
+    char* p = (char*)datos;
+    while (cantidad > 0) {
+        ssize_t leidos = read(fd, p, cantidad);
+        if (leidos < 0 && errno == EINTR) continue;
+        if (leidos <= 0) return 0;
+        p += leidos;
+        cantidad -= (size_t)leidos;
+    }
+    return 1;
+}
+
+static int escribirBloque(int fd, const char* datos, uint64_t longitud) {
+    return escribirTodo(fd, &longitud, sizeof(longitud)) && escribirTodo(fd, datos, longitud);
+}
+
+/* Copia un bloque "uint64 n, n bytes" de la conexion a destino */
+static int reenviarBloque(int fd, FILE* destino) {
+    char buffer[65536];
+    uint64_t longitud;
+    if (!leerTodo(fd, &longitud, sizeof(longitud))) return 0;
+    while (longitud > 0) {
+        size_t parte = longitud < sizeof(buffer) ? (size_t)longitud : sizeof(buffer);
+        if (!leerTodo(fd, buffer, parte)) return 0;
+        fwrite(buffer, 1, parte, destino);
+        longitud -= parte;
+    }
+    return 1;
+}
+
+/* Agrega texto con su '\0' al buffer dinamico */
+static int agregar(char** datos, size_t* longitud, size_t* capacidad, const char* texto) {
+    size_t n = strlen(texto) + 1;
+    if (*longitud + n > *capacidad) {
+        size_t nueva = (*capacidad + n) * 2;
+        char* otro = (char*)realloc(*datos, nueva);
+        if (otro == NULL) return 0;
+        *datos = otro;
+        *capacidad = nueva;
+    }
+    memcpy(*datos + *longitud, texto, n);
+    *longitud += n;
+    return 1;
+}
+
+/* Lee la entrada estandar completa */
+static char* leerEntrada(size_t* longitud) {
+    size_t capacidad = 65536;
+    char* datos = (char*)malloc(capacidad);
+    *longitud = 0;
+    while (datos != NULL) {
+        if (*longitud == capacidad) {
+            char* otro = (char*)realloc(datos, capacidad * 2);
+            if (otro == NULL) {
+                free(datos);
+                return NULL;
+            }
+            datos = otro;
+            capacidad *= 2;
+        }
+        ssize_t leidos = read(STDIN_FILENO, datos + *longitud, capacidad - *longitud);
+        if (leidos < 0 && errno == EINTR) continue;
+        if (leidos < 0) {
+            free(datos);
+            return NULL;
+        }
+        if (leidos == 0) break;
+        *longitud += (size_t)leidos;
+    }
+    return datos;
+}
+
+/* Sin servidor: el ./parser de siempre */
+static int ejecutarLocal(char* argv[]) {
+    const char* barra = strrchr(argv[0], '/');
+    if (barra != NULL) {
+        size_t n = (size_t)(barra - argv[0]) + 1;
+        char* ruta = (char*)malloc(n + sizeof("parser"));
+        if (ruta != NULL) {
+            memcpy(ruta, argv[0], n);
+            memcpy(ruta + n, "parser", sizeof("parser"));
+            argv[0] = ruta;
+            execv(ruta, argv);
+        }
+    }
+    argv[0] = (char*)"parser";
+    execvp("parser", argv);
+    fprintf(stderr, "Error: No hay servidor ni se pudo ejecutar parser: %s\n", strerror(errno));
+    return 1;
+}
+
+static int conectar(const char* ruta) {
+    struct sockaddr_un direccion;
+    if (ruta == NULL || ruta[0] == '\0' || strlen(ruta) >= sizeof(direccion.sun_path)) {
+        return -1;
+    }
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    strcpy(direccion.sun_path, ruta);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&direccion, sizeof(direccion)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+int main(int argc, char* argv[]) {
+    int fd = conectar(getenv("PARSER_SERVIDOR"));
+    if (fd < 0) {
+        return ejecutarLocal(argv);
+    }
+
+    /* El directorio de trabajo y los argumentos, cada uno con su '\0' */
+    char* argumentos = NULL;
+    size_t longitud = 0, capacidad = 0;
+    char directorio[4096];
+    int conEntrada = 0;
+    if (getcwd(directorio, sizeof(directorio)) == NULL ||
+        !agregar(&argumentos, &longitud, &capacidad, directorio)) {
+        fprintf(stderr, "Error: No se pudo armar el pedido al servidor\n");
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (!agregar(&argumentos, &longitud, &capacidad, argv[i])) {
+            fprintf(stderr, "Error: No se pudo armar el pedido al servidor\n");
+            return 1;
+        }
+        if (strcmp(argv[i], "-") == 0 || strcmp(argv[i], "--stdin") == 0) {
+            conEntrada = 1;
+        }
+    }
+    size_t longitudEntrada = 0;
+    char* entrada = conEntrada ? leerEntrada(&longitudEntrada) : NULL;
+    if (conEntrada && entrada == NULL) {
+        fprintf(stderr, "Error: No se pudo leer la entrada estandar\n");
+        return 1;
+    }
+
+    int32_t codigo;
+    if (!escribirBloque(fd, argumentos, longitud) ||
+        !escribirBloque(fd, entrada, longitudEntrada) ||
+        !leerTodo(fd, &codigo, sizeof(codigo)) ||
+        !reenviarBloque(fd, stdout) || !reenviarBloque(fd, stderr)) {
+        fprintf(stderr, "Error: Se perdio la conexion con el servidor\n");
+        return 1;
+    }
+    close(fd);
+    fflush(stdout);
+    return codigo;
+}
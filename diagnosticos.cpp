@@ -0,0 +1,231 @@
+#include <cstring>
+#include "diagnosticos.h"
+
+using namespace std;
+
+// Con mas que esto en el buffer se vuelca al destino
+static const size_t TAMANO_BUFFER = 256 * 1024;
+
+// ============================================================
+// JSON
+// ============================================================
+
+// Largo de la secuencia UTF-8 valida que empieza en p (0 si no lo es)
+static size_t secuenciaUtf8(const unsigned char* p, size_t disponibles) {
+    size_t largo = p[0] >= 0xF0 ? 4 : p[0] >= 0xE0 ? 3 : p[0] >= 0xC2 ? 2 : 0;
+    if (largo == 0 || largo > disponibles || p[0] > 0xF4) {
+        return 0;
+    }
+    for (size_t i = 1; i < largo; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    // Formas largas, sustitutos UTF-16 y mas alla de U+10FFFF
+    if ((p[0] == 0xE0 && p[1] < 0xA0) || (p[0] == 0xED && p[1] >= 0xA0) ||
+        (p[0] == 0xF0 && p[1] < 0x90) || (p[0] == 0xF4 && p[1] >= 0x90)) {
+        return 0;
+    }
+    return largo;
+}
+
+// Agrega un string JSON. Los lexemas son bytes arbitrarios: lo que no es
+// UTF-8 valido se escribe como \u00XX, leyendo el byte como Latin-1.
+static void escribirCadena(string& salida, const char* texto, size_t longitud) {
+    static const char HEX[] = "0123456789abcdef";
+    const unsigned char* p = (const unsigned char*)texto;
+    salida += '"';
+    for (size_t i = 0; i < longitud; i++) {
+        unsigned char c = p[i];
+        if (c == '"' || c == '\\') {
+            salida += '\\';
+            salida += (char)c;
+        } else if (c == '\n') {
+            salida += "\\n";
+        } else if (c == '\t') {
+            salida += "\\t";
+        } else if (c == '\r') {
+            salida += "\\r";
+        } else if (c < 0x20 || c == 0x7F) {
+            salida += "\\u00";
+            salida += HEX[c >> 4];
+            salida += HEX[c & 15];
+        } else if (c < 0x80) {
+            salida += (char)c;
+        } else {
+            size_t largo = secuenciaUtf8(p + i, longitud - i);
+            if (largo > 0) {
+                salida.append(texto + i, largo);
+                i += largo - 1;
+            } else {
+                salida += "\\u00";
+                salida += HEX[c >> 4];
+                salida += HEX[c & 15];
+            }
+        }
+    }
+    salida += '"';
+}
+
+static void escribirCadena(string& salida, const string& texto) {
+    escribirCadena(salida, texto.data(), texto.size());
+}
+
+// Tambien son los ruleId de SARIF (ver ENCABEZADO_SARIF)
+static const char* nombreCodigo(uint8_t codigo) {
+    switch (codigo) {
+        case ERROR_ANIDAMIENTO: return "anidamiento";
+        case ERROR_NO_DECLARADO: return "no-declarado";
+        case ERROR_REDECLARADO: return "redeclarado";
+        case ERROR_NO_ES_FUNCION: return "no-es-funcion";
+        case ERROR_NO_ES_VARIABLE: return "no-es-variable";
+        case ERROR_TIPO: return "tipo";
+        case ERROR_NO_ES_ARREGLO: return "no-es-arreglo";
+        case ERROR_ARGUMENTOS: return "argumentos";
+        case ERROR_SIN_VALOR: return "sin-valor";
+        case ERROR_RETORNO: return "retorno";
+        case ERROR_SIN_ASIGNACION: return "sin-asignacion";
+        case ERROR_DIVISION_CERO: return "division-cero";
+        case ERROR_DESBORDE: return "desborde";
+        default: return "esperaba";
+    }
+}
+
+// ============================================================
+// Formatos
+// ============================================================
+
+void escribirJsonl(const ParserContext& ctx, const string& archivo, string& salida) {
+    string archivoJson, texto;
+    escribirCadena(archivoJson, archivo);
+    for (const ErrorInfo& error : ctx.errores) {
+        salida += "{\"archivo\":";
+        salida += archivoJson;
+        salida += ",\"linea\":";
+        salida += to_string(error.linea);
+        salida += ",\"columna\":";
+        salida += to_string(error.columna);
+        salida += ",\"offset\":";
+        salida += to_string(error.offset);
+        salida += ",\"longitud\":";
+        salida += to_string(error.longitud);
+        salida += ",\"codigo\":\"";
+        salida += nombreCodigo(error.codigo);
+        salida += "\",\"esperado\":";
+        if (error.codigo == ERROR_ESPERABA) {
+            escribirCadena(salida, error.esperado, strlen(error.esperado));
+        } else {
+            salida += "null";
+        }
+        salida += ",\"encontrado\":";
+        texto.clear();
+        escribirEncontrado(ctx, error, texto);
+        escribirCadena(salida, texto);
+        salida += ",\"mensaje\":";
+        texto.clear();
+        escribirMensaje(ctx, error, texto);
+        escribirCadena(salida, texto);
+        salida += "}\n";
+    }
+}
+
+void escribirResultadosSarif(const ParserContext& ctx, const string& archivo, string& salida) {
+    string archivoJson, texto;
+    escribirCadena(archivoJson, archivo);
+    for (const ErrorInfo& error : ctx.errores) {
+        salida += ",\n    {\"ruleId\":\"";
+        salida += nombreCodigo(error.codigo);
+        salida += "\",\"level\":\"error\",\"message\":{\"text\":";
+        texto.clear();
+        escribirMensaje(ctx, error, texto);
+        escribirCadena(salida, texto);
+        salida += "},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":";
+        salida += archivoJson;
+        salida += "},\"region\":{\"startLine\":";
+        salida += to_string(error.linea);
+        salida += ",\"startColumn\":";
+        salida += to_string(error.columna);
+        salida += ",\"byteOffset\":";
+        salida += to_string(error.offset);
+        salida += ",\"byteLength\":";
+        salida += to_string(error.longitud);
+        salida += "}}}],\"properties\":{";
+        if (error.codigo == ERROR_ESPERABA) {
+            salida += "\"esperado\":";
+            escribirCadena(salida, error.esperado, strlen(error.esperado));
+            salida += ',';
+        }
+        salida += "\"encontrado\":";
+        texto.clear();
+        escribirEncontrado(ctx, error, texto);
+        escribirCadena(salida, texto);
+        salida += "}}";
+    }
+}
+
+// ============================================================
+// Salida
+// ============================================================
+
+static const char* const ENCABEZADO_SARIF =
+    "{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"version\":\"2.1.0\",\n"
+    " \"runs\":[{\"tool\":{\"driver\":{\"name\":\"parser\",\"rules\":[\n"
+    "  {\"id\":\"esperaba\",\"shortDescription\":{\"text\":\"Token inesperado\"}},\n"
+    "  {\"id\":\"anidamiento\",\"shortDescription\":{\"text\":\"Anidamiento excesivo\"}},\n"
+    "  {\"id\":\"no-declarado\",\"shortDescription\":{\"text\":\"Nombre no declarado\"}},\n"
+    "  {\"id\":\"redeclarado\",\"shortDescription\":{\"text\":\"Nombre ya declarado\"}},\n"
+    "  {\"id\":\"no-es-funcion\",\"shortDescription\":{\"text\":\"Llamada a una variable\"}},\n"
+    "  {\"id\":\"no-es-variable\",\"shortDescription\":{\"text\":\"Funcion como variable\"}},\n"
+    "  {\"id\":\"tipo\",\"shortDescription\":{\"text\":\"Tipos incompatibles\"}},\n"
+    "  {\"id\":\"no-es-arreglo\",\"shortDescription\":{\"text\":\"Indice sobre un no arreglo\"}},\n"
+    "  {\"id\":\"argumentos\",\"shortDescription\":{\"text\":\"Cantidad de argumentos\"}},\n"
+    "  {\"id\":\"sin-valor\",\"shortDescription\":{\"text\":\"Funcion sin valor\"}},\n"
+    "  {\"id\":\"retorno\",\"shortDescription\":{\"text\":\"Return incompatible\"}},\n"
+    "  {\"id\":\"sin-asignacion\",\"shortDescription\":{\"text\":\"Asignacion sin valor\"}},\n"
+    "  {\"id\":\"division-cero\",\"shortDescription\":{\"text\":\"Division por cero constante\"}},\n"
+    "  {\"id\":\"desborde\",\"shortDescription\":{\"text\":\"Constante fuera de rango\"}}]}},\n"
+    "  \"results\":[";
+static const char* const CIERRE_SARIF = "]}]}\n";
+
+static void volcar(SalidaDiagnosticos& salida) {
+    salida.destino->write(salida.buffer.data(), salida.buffer.size());
+    salida.buffer.clear();
+}
+
+void abrirSalida(SalidaDiagnosticos& salida, ostream& destino, FormatoDiagnosticos formato) {
+    salida.destino = &destino;
+    salida.formato = formato;
+    salida.buffer.clear();
+    salida.buffer.reserve(TAMANO_BUFFER);
+    salida.primerResultado = true;
+    if (formato == DIAGNOSTICOS_SARIF) {
+        salida.buffer += ENCABEZADO_SARIF;
+    }
+}
+
+void agregarDiagnosticos(SalidaDiagnosticos& salida, const string& registros) {
+    size_t desde = 0;
+    if (salida.formato == DIAGNOSTICOS_SARIF && salida.primerResultado && !registros.empty()) {
+        desde = 1;      // la coma del primer resultado
+        salida.primerResultado = false;
+    }
+    if (salida.buffer.size() + registros.size() - desde > TAMANO_BUFFER) {
+        volcar(salida);
+        if (registros.size() - desde > TAMANO_BUFFER) {
+            salida.destino->write(registros.data() + desde, registros.size() - desde);
+            return;
+        }
+    }
+    salida.buffer.append(registros, desde, string::npos);
+}
+
+void terminarSalida(SalidaDiagnosticos& salida) {
+    if (salida.formato == DIAGNOSTICOS_SARIF) {
+        if (!salida.primerResultado) {
+            salida.buffer += "\n  ";
+        }
+        salida.buffer += CIERRE_SARIF;
+    }
+    volcar(salida);
+    salida.destino->flush();
+}
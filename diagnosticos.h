@@ -0,0 +1,42 @@
+#ifndef DIAGNOSTICOS_H
+#define DIAGNOSTICOS_H
+
+#include <ostream>
+#include <string>
+#include "parser.h"
+
+// Formato de los errores sintacticos (--diagnosticos=...)
+enum FormatoDiagnosticos {
+    DIAGNOSTICOS_TEXTO,     // mostrarErrores, en stderr
+    DIAGNOSTICOS_JSONL,     // un objeto JSON por linea y error, en stdout
+    DIAGNOSTICOS_SARIF      // un documento SARIF 2.1.0 con todos los archivos, en stdout
+};
+
+// Errores de ctx como lineas JSON, cada una con el archivo, la posicion
+// (linea, columna, offset y longitud en bytes), el codigo, lo esperado, lo
+// encontrado y el mensaje
+void escribirJsonl(const ParserContext& ctx, const std::string& archivo, std::string& salida);
+
+// Errores de ctx como "results" de SARIF, cada uno precedido por una coma
+// (agregarDiagnosticos saltea la del primero del documento)
+void escribirResultadosSarif(const ParserContext& ctx, const std::string& archivo,
+                             std::string& salida);
+
+// Salida de los diagnosticos de muchos archivos, en orden, a un mismo
+// stream. Acumula en un buffer propio que se vuelca de a bloques cuando se
+// llena, y hace un solo flush al terminar.
+struct SalidaDiagnosticos {
+    std::ostream* destino = nullptr;
+    FormatoDiagnosticos formato = DIAGNOSTICOS_JSONL;
+    std::string buffer;
+    bool primerResultado = true;
+};
+
+// Empieza la salida (el encabezado del documento SARIF)
+void abrirSalida(SalidaDiagnosticos& salida, std::ostream& destino, FormatoDiagnosticos formato);
+// Agrega lo que escribio escribirJsonl o escribirResultadosSarif
+void agregarDiagnosticos(SalidaDiagnosticos& salida, const std::string& registros);
+// Cierra el documento SARIF y vuelca lo que quede
+void terminarSalida(SalidaDiagnosticos& salida);
+
+#endif
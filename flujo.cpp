@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstring>
+#include <sys/resource.h>
+#include "flujo.h"
+#include "parser.h"
+#include "tokens.h"
+#include "lexersimd.h"
+
+static const size_t TAMANO_LECTURA = 64 * 1024;
+
+// Descarta los tokens anteriores al lookahead y los bytes anteriores a su
+// lexema: ni el parser ni los mensajes de error vuelven a mirarlos
+static void compactar(ParserContext& ctx, FlujoEntrada& f) {
+    TokenBuffer& t = ctx.tokens;
+    size_t n = ctx.posToken;
+    if (n > t.cantidad()) n = t.cantidad();
+    size_t desde = n < t.cantidad() ? t.offsets[n] : f.inicioLexer;
+
+    t.tipos.erase(t.tipos.begin(), t.tipos.begin() + n);
+    t.offsets.erase(t.offsets.begin(), t.offsets.begin() + n);
+    t.longitudes.erase(t.longitudes.begin(), t.longitudes.begin() + n);
+    t.valores.erase(t.valores.begin(), t.valores.begin() + n);
+    ctx.posToken -= n;
+    if (ctx.tokenUltimoError != SIN_ERROR_PREVIO) {
+        ctx.tokenUltimoError = ctx.tokenUltimoError >= n ? ctx.tokenUltimoError - n
+                                                         : SIN_ERROR_PREVIO;
+    }
+
+    if (desde > 0) {
+        descartarPrefijo(ctx.lineas, f.datos.data(), desde);
+        for (uint32_t& o : t.offsets) {
+            o -= (uint32_t)desde;
+        }
+        memmove(f.datos.data(), f.datos.data() + desde, f.longitud - desde);
+        f.longitud -= desde;
+        f.inicioLexer -= desde;
+        f.finUltimoToken -= desde;
+        f.descartados += desde;
+    }
+}
+
+static void leer(FlujoEntrada& f, size_t cantidad) {
+    if (f.datos.size() < f.longitud + cantidad + 2) {
+        f.datos.resize(f.longitud + cantidad + 2);
+    }
+    size_t leidos = fread(f.datos.data() + f.longitud, 1, cantidad, f.archivo);
+    f.longitud += leidos;
+    f.bytesLeidos += leidos;
+    if (leidos < cantidad && (feof(f.archivo) || ferror(f.archivo))) {
+        f.finEntrada = true;
+    }
+}
+
+// Ultimo punto donde se puede cortar la entrada sin cambiar los tokens:
+// justo despues de un '\n' seguido de algo que no sea sangria (asi T_NL,
+// que es \n[ \t]*, queda completo). 0 si no hay ninguno.
+static size_t ultimoCorte(const FlujoEntrada& f) {
+    for (size_t p = f.longitud - 1; p + 1 > f.inicioLexer + 1; p--) {
+        char c = f.datos[p];
+        if (f.datos[p - 1] == '\n' && c != ' ' && c != '\t') {
+            return p;
+        }
+    }
+    return 0;
+}
+
+// Tokeniza desde inicioLexer hasta el ultimo corte seguro (o hasta el final
+// si la entrada termino) y agrega los tokens a ctx.tokens
+static void tokenizarPendiente(ParserContext& ctx, FlujoEntrada& f) {
+    size_t corte = f.finEntrada ? f.longitud : ultimoCorte(f);
+    if (corte <= f.inicioLexer && !f.finEntrada) {
+        return;
+    }
+
+    // El lexer necesita dos '\0' despues del segmento; se escriben sobre la
+    // entrada ya leida y se restauran al terminar
+    char guardado[2] = {f.datos[corte], f.datos[corte + 1]};
+    f.datos[corte] = '\0';
+    f.datos[corte + 1] = '\0';
+    char* segmento = f.datos.data() + f.inicioLexer;
+    size_t longitudSegmento = corte - f.inicioLexer;
+    TokenBuffer seg;
+    if (f.lexerSimd) {
+        tokenizarSimd(seg, ctx.interner, segmento, longitudSegmento);
+    } else {
+        tokenizar(seg, ctx.interner, segmento, longitudSegmento);
+    }
+    f.datos[corte] = guardado[0];
+    f.datos[corte + 1] = guardado[1];
+
+    size_t n = seg.cantidad() - 1;  // sin T_EOF
+    size_t reinicio = corte;
+    if (!f.finEntrada && n > 0) {
+        // Un comentario o string sin cerrar al final del segmento puede
+        // cerrarse en la entrada que falta: se descarta y se vuelve a
+        // tokenizar desde el final del token anterior cuando haya mas
+        size_t u = n - 1;
+        bool abierto = seg.tipos[u] == T_ERROR &&
+                       (seg.longitudes[u] == 0 ||
+                        (segmento[seg.offsets[u]] == '"' &&
+                         seg.offsets[u] + seg.longitudes[u] == longitudSegmento));
+        if (abierto) {
+            n = u;
+            reinicio = n > 0 ? f.inicioLexer + seg.offsets[n - 1] + seg.longitudes[n - 1]
+                             : f.inicioLexer;
+        }
+    }
+
+    TokenBuffer& t = ctx.tokens;
+    for (size_t i = 0; i < n; i++) {
+        t.agregar(seg.tipos[i], (uint32_t)(f.inicioLexer + seg.offsets[i]), seg.longitudes[i],
+                  seg.valores[i]);
+    }
+    if (n > 0) {
+        f.finUltimoToken = t.offsets.back() + t.longitudes.back();
+    }
+    f.tokensTotales += n;
+
+    if (f.finEntrada) {
+        // T_EOF va al final del ultimo token, aunque sea de otro segmento
+        t.agregar(T_EOF, (uint32_t)f.finUltimoToken, 0, 0);
+        f.tokensTotales++;
+        f.terminado = true;
+        reinicio = f.longitud;
+    }
+    f.inicioLexer = reinicio;
+}
+
+bool recargarTokens(ParserContext& ctx) {
+    FlujoEntrada& f = *ctx.flujo;
+    if (f.terminado) {
+        return false;
+    }
+    compactar(ctx, f);
+
+    size_t antes = ctx.tokens.cantidad();
+    while (ctx.tokens.cantidad() == antes && !f.terminado) {
+        // Lo pendiente se vuelve a tokenizar completo: leer al menos otro
+        // tanto evita un costo cuadratico con comentarios muy largos
+        size_t pendiente = f.longitud - f.inicioLexer;
+        if (!f.finEntrada) {
+            leer(f, std::max(TAMANO_LECTURA, pendiente));
+        }
+        tokenizarPendiente(ctx, f);
+    }
+    ctx.tokens.fuente = f.datos.data();
+    ctx.tokens.longitudFuente = f.longitud;
+    ctx.lineas.construido = false;
+    return ctx.tokens.cantidad() > antes;
+}
+
+long memoriaMaximaKB() {
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) {
+        return 0;
+    }
+    return uso.ru_maxrss;
+}
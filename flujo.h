@@ -0,0 +1,39 @@
+#ifndef FLUJO_H
+#define FLUJO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+struct ParserContext;
+
+// Entrada incremental (--stdin o '-'): en vez de cargar todo el archivo,
+// el parser pide tokens a medida que los consume. Solo se retienen los
+// bytes desde el token actual del parser hasta lo ultimo leido, asi que la
+// memoria no crece con el tamano de la entrada.
+struct FlujoEntrada {
+    FILE* archivo = nullptr;
+    bool lexerSimd = false;
+
+    std::vector<char> datos;    // bytes retenidos (con dos '\0' de reserva al final)
+    size_t longitud = 0;        // bytes validos en datos
+    size_t inicioLexer = 0;     // primer byte de datos aun no tokenizado
+    size_t finUltimoToken = 0;  // fin del ultimo token agregado (offset de T_EOF)
+    size_t descartados = 0;     // bytes de la entrada anteriores a datos[0]
+    bool finEntrada = false;    // archivo agotado
+    bool terminado = false;     // ya se agrego T_EOF
+
+    size_t bytesLeidos = 0;     // total leido del archivo
+    size_t tokensTotales = 0;   // total de tokens agregados
+};
+
+// Tokeniza mas entrada y la agrega al final de ctx.tokens, descartando
+// antes los tokens ya consumidos (los anteriores a ctx.posToken) y sus
+// bytes, de los que ctx.lineas solo conserva la cuenta de lineas. Devuelve false si la entrada ya termino y no hay tokens nuevos.
+bool recargarTokens(ParserContext& ctx);
+
+// Memoria residente maxima del proceso, en KB
+long memoriaMaximaKB();
+
+#endif
@@ -0,0 +1,101 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdlib>
+#include "fuente.h"
+
+bool mapearFuente(const char* ruta, Fuente& fuente) {
+    fuente.datos = nullptr;
+    fuente.longitud = 0;
+    fuente.reservado = 0;
+
+    int fd = open(ruta, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return false;
+    }
+
+    // Se reserva una region anonima de longitud + 2 bytes y se proyecta el
+    // archivo encima. Lo que queda despues del fin del archivo son ceros,
+    // asi que los dos '\0' que pide flex ya estan ahi aunque el tamano sea
+    // multiplo exacto de la pagina. MAP_PRIVATE porque flex escribe
+    // temporalmente un '\0' al final de yytext (copia en escritura).
+    size_t longitud = (size_t)info.st_size;
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    size_t reservado = (longitud + 2 + pagina - 1) / pagina * pagina;
+
+    void* base = mmap(nullptr, reservado, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    if (longitud > 0) {
+        void* archivo = mmap(base, longitud, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (archivo == MAP_FAILED) {
+            munmap(base, reservado);
+            close(fd);
+            return false;
+        }
+        madvise(base, longitud, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    fuente.datos = (char*)base;
+    fuente.longitud = longitud;
+    fuente.reservado = reservado;
+    return true;
+}
+
+bool leerFuente(FILE* archivo, Fuente& fuente) {
+    size_t capacidad = 1 << 16;
+    size_t longitud = 0;
+    char* datos = (char*)malloc(capacidad);
+    if (datos == nullptr) {
+        return false;
+    }
+
+    size_t leidos;
+    while ((leidos = fread(datos + longitud, 1, capacidad - longitud - 2, archivo)) > 0) {
+        longitud += leidos;
+        if (capacidad - longitud - 2 == 0) {
+            char* nuevo = (char*)realloc(datos, capacidad * 2);
+            if (nuevo == nullptr) {
+                free(datos);
+                return false;
+            }
+            datos = nuevo;
+            capacidad *= 2;
+        }
+    }
+    if (ferror(archivo)) {
+        free(datos);
+        return false;
+    }
+
+    datos[longitud] = '\0';
+    datos[longitud + 1] = '\0';
+    fuente.datos = datos;
+    fuente.longitud = longitud;
+    fuente.reservado = 0;
+    return true;
+}
+
+void liberarFuente(Fuente& fuente) {
+    if (fuente.reservado > 0) {
+        munmap(fuente.datos, fuente.reservado);
+    } else {
+        free(fuente.datos);
+    }
+    fuente.datos = nullptr;
+    fuente.longitud = 0;
+    fuente.reservado = 0;
+}
@@ -0,0 +1,26 @@
+#ifndef FUENTE_H
+#define FUENTE_H
+
+#include <cstddef>
+
+#include <cstdio>
+
+// Archivo fuente completo en memoria. El lexer lo recorre en su lugar
+// (yy_scan_buffer), sin copiarlo a los buffers de flex, y los tokens
+// guardan offsets sobre el.
+struct Fuente {
+    char* datos;        // contenido seguido de dos '\0' (requisito de flex)
+    size_t longitud;    // bytes del archivo, sin contar los '\0' finales
+    size_t reservado;   // bytes proyectados con mmap (0 si datos esta en el heap)
+};
+
+// Proyecta el archivo con mmap. Devuelve false si no es un archivo regular
+// (pipe, FIFO, dispositivo) o si mmap falla; en ese caso usar leerFuente.
+bool mapearFuente(const char* ruta, Fuente& fuente);
+
+// Lee el stream completo a un buffer del heap
+bool leerFuente(FILE* archivo, Fuente& fuente);
+
+void liberarFuente(Fuente& fuente);
+
+#endif
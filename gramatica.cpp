@@ -0,0 +1,63 @@
+#include <ostream>
+#include <string>
+#include "gramatica.h"
+#include "parser.h"
+
+using namespace std;
+
+static string nombreSimbolo(Simbolo s) {
+    if (esNoTerminal(s)) {
+        return NO_TERMINALES[s - PRIMER_NO_TERMINAL].nombre;
+    }
+    if (esAccion(s)) {
+        return ACCIONES[s - PRIMERA_ACCION].nombre;
+    }
+    string nombre = nombreToken(s);
+    return nombre[0] == '\'' ? nombre : "'" + nombre + "'";
+}
+
+static void imprimirConjunto(ostream& salida, const ConjuntoTokens& conjunto) {
+    salida << "{";
+    const char* separador = " ";
+    for (int t : conjunto.tokens()) {
+        salida << separador << nombreSimbolo((Simbolo)t);
+        separador = ", ";
+    }
+    salida << " }";
+}
+
+void imprimirGramatica(ostream& salida) {
+    salida << "=== PRODUCCIONES ===" << endl;
+    for (size_t k = 0; k < CANTIDAD_PRODUCCIONES; k++) {
+        const Produccion& p = PRODUCCIONES[k];
+        salida << k << ": " << nombreSimbolo(p.izquierda) << " ->";
+        if (p.longitud == 0) {
+            salida << " /* vacio */";
+        }
+        for (size_t i = 0; i < p.longitud; i++) {
+            salida << " " << nombreSimbolo(p.derecha[i]);
+        }
+        salida << endl;
+    }
+
+    salida << "\n=== FIRST / FOLLOW ===" << endl;
+    for (size_t n = 0; n < CANTIDAD_NO_TERMINALES; n++) {
+        salida << NO_TERMINALES[n].nombre << (ANALISIS_LL1.anulable[n] ? " (anulable)" : "")
+               << "\n  FIRST  ";
+        imprimirConjunto(salida, ANALISIS_LL1.primeros[n]);
+        salida << "\n  FOLLOW ";
+        imprimirConjunto(salida, ANALISIS_LL1.siguientes[n]);
+        salida << endl;
+    }
+
+    size_t celdas = 0;
+    for (size_t n = 0; n < CANTIDAD_NO_TERMINALES; n++) {
+        for (size_t c = 0; c < ANALISIS_LL1.columnas; c++) {
+            celdas += ANALISIS_LL1.tabla[n][c] != SIN_PRODUCCION;
+        }
+    }
+    salida << "\n=== TABLA LL(1) ===" << endl;
+    salida << CANTIDAD_NO_TERMINALES << " no terminales x " << ANALISIS_LL1.columnas
+           << " columnas, " << celdas << " celdas con produccion, "
+           << sizeof(ANALISIS_LL1.tabla) << " bytes" << endl;
+}
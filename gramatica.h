@@ -0,0 +1,616 @@
+#ifndef GRAMATICA_H
+#define GRAMATICA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <vector>
+#include "tokens.h"
+
+// ============================================================
+// Gramatica LL(1) de Mini-0
+// ============================================================
+// La misma gramatica que reconoce parser.cpp, factorizada a izquierda y sin
+// repeticiones { }, para que un solo token de lookahead elija siempre la
+// produccion. A partir de ella se calculan en tiempo de compilacion los
+// conjuntos FIRST y FOLLOW, la tabla LL(1) que usa el analizador de
+// ll1.cpp y los conjuntos de sincronizacion del analizador descendente.
+//
+// Un simbolo es un terminal (el token, < 256), un no terminal o una accion.
+// Las acciones no consumen tokens: el analizador de tabla las ejecuta al
+// sacarlas de la pila y construyen el mismo arbol que parser.cpp.
+
+typedef uint16_t Simbolo;
+
+const Simbolo PRIMER_NO_TERMINAL = 256;
+const Simbolo PRIMERA_ACCION = 512;
+
+enum NoTerminal : Simbolo {
+    NT_PROGRAMA = PRIMER_NO_TERMINAL,
+    NT_DECLS,
+    NT_DECLARACION,
+    NT_DECL,
+    NT_GLOBAL,
+    NT_FUNCION,
+    NT_PARAMS,
+    NT_MASPARAMS,
+    NT_PARAMETRO,
+    NT_RETORNO,
+    NT_TIPO,
+    NT_DIMENSIONES,
+    NT_TIPOBASE,
+    NT_FINLINEA,
+    NT_NLS,
+    NT_BLOQUE,
+    NT_CUERPO,
+    NT_RESTOID,
+    NT_COMANDOS,
+    NT_COMANDO,
+    NT_RESTOCOMANDO,
+    NT_CMDIF,
+    NT_ELSES,
+    NT_RESTOELSE,
+    NT_CMDWHILE,
+    NT_CMDRETURN,
+    NT_VALORRETORNO,
+    NT_INDICES,
+    NT_LISTAEXP,
+    NT_MASEXP,
+    NT_EXP,
+    NT_MASOR,
+    NT_EXPAND,
+    NT_MASAND,
+    NT_EXPREL,
+    NT_MASREL,
+    NT_OPREL,
+    NT_EXPADD,
+    NT_MASADD,
+    NT_OPADD,
+    NT_EXPMUL,
+    NT_MASMUL,
+    NT_OPMUL,
+    NT_UNARIA,
+    NT_OPUNARIO,
+    NT_FACTOR,
+    NT_LITERAL,
+    NT_RESTOFACTOR,
+    FIN_NO_TERMINALES
+};
+
+const size_t CANTIDAD_NO_TERMINALES = FIN_NO_TERMINALES - PRIMER_NO_TERMINAL;
+
+// Las acciones trabajan sobre tres pilas del analizador: la de nodos
+// (Ast::pila), la de tokens guardados (tipo, offset y valor de un token ya
+// consumido) y la de marcos (posicion de Ast::pila donde empiezan los
+// hijos de un nodo con cantidad variable de hijos).
+enum Accion : Simbolo {
+    A_MARCO = PRIMERA_ACCION,   // abre un marco
+    A_TOKEN,        // guarda el lookahead
+    A_NULO,         // apila NODO_NULO (parte opcional ausente)
+    A_PROGRAMA,     // cierra el marco: N_PROGRAMA
+    A_INICIO_DECL,  // marca la arena antes de una declaracion
+    A_FIN_DECL,     // sin retenerAst, libera la declaracion
+    A_FUNCION,      // cierra el marco: N_FUNCION con el nombre guardado
+    A_PARAMETRO,    // N_PARAMETRO con el nombre guardado y el tipo apilado
+    A_DECLVAR,      // N_DECLVAR, igual que A_PARAMETRO
+    A_DIMENSION,    // cuenta un '[' ']' del tipo en curso
+    A_TIPO,         // N_TIPO con el primer token y el tipo base guardados
+    A_BLOQUE,       // cierra el marco: N_BLOQUE
+    A_IF,           // cierra el marco: N_IF
+    A_WHILE,        // N_WHILE con condicion y bloque apilados
+    A_RETURN,       // N_RETURN con la expresion apilada
+    A_RETURN_VACIO, // N_RETURN sin expresion
+    A_LLAMADA,      // cierra el marco: N_LLAMADA con el nombre guardado
+    A_VARIABLE,     // N_VAR con el nombre guardado
+    A_INDEXAR,      // N_INDEXAR con arreglo e indice apilados
+    A_ATRIB,        // N_ATRIB con destino y valor apilados
+    A_BINARIA,      // N_BINARIA con el operador guardado
+    A_UNARIA,       // N_UNARIA con el operador guardado
+    A_LITERAL,      // N_NUMERO, N_STRING o N_BOOL segun el token guardado
+    A_NEW,          // N_NEW con tamano y tipo apilados
+    FIN_ACCIONES
+};
+
+const size_t CANTIDAD_ACCIONES = FIN_ACCIONES - PRIMERA_ACCION;
+
+constexpr bool esTerminal(Simbolo s) { return s < PRIMER_NO_TERMINAL; }
+constexpr bool esNoTerminal(Simbolo s) { return s >= PRIMER_NO_TERMINAL && s < FIN_NO_TERMINALES; }
+constexpr bool esAccion(Simbolo s) { return s >= PRIMERA_ACCION; }
+
+// Efecto de un no terminal sobre las pilas del analizador, que se verifica
+// contra cada una de sus producciones. Con VALORES_VARIABLES (listas que
+// solo aparecen dentro de un marco) no se controla la pila de nodos.
+const int VALORES_VARIABLES = -1;
+
+struct NoTerminalInfo {
+    const char* nombre;
+    const char* esperado;   // para "Se esperaba ..." cuando no hay produccion
+    int valores;            // nodos que deja apilados
+    int tokens;             // tokens guardados que consume (<= 0)
+};
+
+constexpr NoTerminalInfo NO_TERMINALES[CANTIDAD_NO_TERMINALES] = {
+    {"programa",      "al menos una declaracion",               1, 0},
+    {"decls",         "declaracion (fun o identificador)",      VALORES_VARIABLES, 0},
+    {"declaracion",   "declaracion (fun o identificador)",      VALORES_VARIABLES, 0},
+    {"decl",          "declaracion (fun o identificador)",      1, 0},
+    {"global",        "identificador",                          1, 0},
+    {"funcion",       "fun",                                    1, 0},
+    {"params",        "parametro o ')'",                        VALORES_VARIABLES, 0},
+    {"masparams",     "',' o ')'",                              VALORES_VARIABLES, 0},
+    {"parametro",     "nombre de parametro",                    1, 0},
+    {"retorno",       "':' o salto de linea",                   1, 0},
+    {"tipo",          "tipo (int, bool, char, string)",         1, 0},
+    {"dimensiones",   "tipo (int, bool, char, string)",         0, 0},
+    {"tipobase",      "tipo (int, bool, char, string)",         0, 0},
+    {"finlinea",      "salto de linea",                         0, 0},
+    {"nls",           "salto de linea",                         0, 0},
+    {"bloque",        "comando (if, while, return, identificador)", 1, 0},
+    {"cuerpo",        "comando (if, while, return, identificador)", VALORES_VARIABLES, 0},
+    {"restoid",       "':' o '=' o '('",                        VALORES_VARIABLES, -1},
+    {"comandos",      "comando (if, while, return, identificador)", VALORES_VARIABLES, 0},
+    {"comando",       "comando (if, while, return, identificador)", 1, 0},
+    {"restocomando",  "'=' o '('",                              1, -1},
+    {"cmdif",         "if",                                     1, 0},
+    {"elses",         "'else' o 'end'",                         VALORES_VARIABLES, 0},
+    {"restoelse",     "'if' o salto de linea",                  VALORES_VARIABLES, 0},
+    {"cmdwhile",      "while",                                  1, 0},
+    {"cmdreturn",     "return",                                 1, 0},
+    {"valorretorno",  "expresion o salto de linea",             1, -1},
+    {"indices",       "'['",                                    0, 0},
+    {"listaexp",      "expresion o ')'",                        VALORES_VARIABLES, 0},
+    {"masexp",        "',' o ')'",                              VALORES_VARIABLES, 0},
+    {"exp",           "expresion",                              1, 0},
+    {"masor",         "operador",                               0, 0},
+    {"expand",        "expresion",                              1, 0},
+    {"masand",        "operador",                               0, 0},
+    {"exprel",        "expresion",                              1, 0},
+    {"masrel",        "operador",                               0, 0},
+    {"oprel",         "operador relacional",                    0, 0},
+    {"expadd",        "expresion",                              1, 0},
+    {"masadd",        "operador",                               0, 0},
+    {"opadd",         "'+' o '-'",                              0, 0},
+    {"expmul",        "expresion",                              1, 0},
+    {"masmul",        "operador",                               0, 0},
+    {"opmul",         "'*' o '/'",                              0, 0},
+    {"unaria",        "expresion",                              1, 0},
+    {"opunario",      "'not' o '-'",                            0, 0},
+    {"factor",        "expresion",                              1, 0},
+    {"literal",       "expresion",                              0, 0},
+    {"restofactor",   "expresion",                              1, -1},
+};
+
+struct AccionInfo {
+    const char* nombre;
+    int valores;        // nodos que apila menos los que desapila
+    int tokens;         // tokens guardados que apila menos los que desapila
+    int marcos;         // +1 abre un marco, -1 lo cierra (y apila el nodo)
+};
+
+constexpr AccionInfo ACCIONES[CANTIDAD_ACCIONES] = {
+    {"@marco",       0,  0,  1},
+    {"@token",       0,  1,  0},
+    {"@nulo",        1,  0,  0},
+    {"@programa",    0,  0, -1},
+    {"@iniciodecl",  0,  0,  0},
+    {"@findecl",     0,  0,  0},
+    {"@funcion",     0, -1, -1},
+    {"@parametro",   0, -1,  0},
+    {"@declvar",     0, -1,  0},
+    {"@dimension",   0,  0,  0},
+    {"@tipo",        1, -2,  0},
+    {"@bloque",      0, -1, -1},
+    {"@if",          0, -1, -1},
+    {"@while",      -1, -1,  0},
+    {"@return",      0, -1,  0},
+    {"@returnvacio", 1, -1,  0},
+    {"@llamada",     0, -1, -1},
+    {"@variable",    1, -1,  0},
+    {"@indexar",    -1, -1,  0},
+    {"@atrib",      -1, -1,  0},
+    {"@binaria",    -1, -1,  0},
+    {"@unaria",      0, -1,  0},
+    {"@literal",     1, -1,  0},
+    {"@new",        -1, -1,  0},
+};
+
+const size_t MAX_DERECHA = 16;
+
+struct Produccion {
+    Simbolo izquierda;
+    uint8_t longitud;
+    Simbolo derecha[MAX_DERECHA];
+
+    constexpr Produccion(Simbolo izq, std::initializer_list<Simbolo> der)
+        : izquierda(izq), longitud(0), derecha{} {
+        for (Simbolo s : der) {
+            derecha[longitud++] = s;
+        }
+    }
+};
+
+// Las producciones de un mismo no terminal van juntas; una lista vacia es
+// la produccion vacia. Al lado, la regla de parser.cpp a la que equivalen.
+constexpr Produccion PRODUCCIONES[] = {
+    // programa -> { NL } decl { decl }
+    {NT_PROGRAMA, {A_MARCO, NT_NLS, NT_DECLARACION, NT_DECLS, A_PROGRAMA}},
+    {NT_DECLS, {NT_DECLARACION, NT_DECLS}},
+    {NT_DECLS, {}},
+    {NT_DECLARACION, {A_INICIO_DECL, NT_DECL, A_FIN_DECL}},
+
+    // decl -> funcion | global
+    {NT_DECL, {NT_FUNCION}},
+    {NT_DECL, {NT_GLOBAL}},
+    // global -> declvar nl
+    {NT_GLOBAL, {A_TOKEN, T_ID, ':', NT_TIPO, A_DECLVAR, NT_FINLINEA}},
+
+    // funcion -> 'fun' ID '(' params ')' [ ':' tipo ] nl bloque 'end' nl
+    {NT_FUNCION, {T_FUN, A_TOKEN, T_ID, '(', A_MARCO, NT_PARAMS, ')', NT_RETORNO,
+                  NT_FINLINEA, NT_BLOQUE, T_END, NT_FINLINEA, A_FUNCION}},
+    // params -> /* vacio */ | parametro { ',' parametro }
+    {NT_PARAMS, {NT_PARAMETRO, NT_MASPARAMS}},
+    {NT_PARAMS, {}},
+    {NT_MASPARAMS, {',', NT_PARAMETRO, NT_MASPARAMS}},
+    {NT_MASPARAMS, {}},
+    // parametro -> ID ':' tipo
+    {NT_PARAMETRO, {A_TOKEN, T_ID, ':', NT_TIPO, A_PARAMETRO}},
+    {NT_RETORNO, {':', NT_TIPO}},
+    {NT_RETORNO, {A_NULO}},
+
+    // tipo -> tipobase | '[' ']' tipo
+    {NT_TIPO, {A_TOKEN, NT_DIMENSIONES, A_TOKEN, NT_TIPOBASE, A_TIPO}},
+    {NT_DIMENSIONES, {'[', ']', A_DIMENSION, NT_DIMENSIONES}},
+    {NT_DIMENSIONES, {}},
+    // tipobase -> 'int' | 'bool' | 'char' | 'string'
+    {NT_TIPOBASE, {T_INT}},
+    {NT_TIPOBASE, {T_BOOL}},
+    {NT_TIPOBASE, {T_CHAR}},
+    {NT_TIPOBASE, {T_STRING}},
+
+    // nl -> NL { NL }
+    {NT_FINLINEA, {T_NL, NT_NLS}},
+    {NT_NLS, {T_NL, NT_NLS}},
+    {NT_NLS, {}},
+
+    // bloque -> { declvar nl } { comando nl }
+    // Las declaraciones y el primer comando que empieza con un
+    // identificador comparten el ID: se decide en restoid
+    {NT_BLOQUE, {A_TOKEN, A_MARCO, NT_CUERPO, A_BLOQUE}},
+    {NT_CUERPO, {A_TOKEN, T_ID, NT_RESTOID}},
+    {NT_CUERPO, {NT_CMDIF, NT_FINLINEA, NT_COMANDOS}},
+    {NT_CUERPO, {NT_CMDWHILE, NT_FINLINEA, NT_COMANDOS}},
+    {NT_CUERPO, {NT_CMDRETURN, NT_FINLINEA, NT_COMANDOS}},
+    {NT_CUERPO, {}},
+    {NT_RESTOID, {':', NT_TIPO, A_DECLVAR, NT_FINLINEA, NT_CUERPO}},
+    {NT_RESTOID, {NT_RESTOCOMANDO, NT_FINLINEA, NT_COMANDOS}},
+    {NT_COMANDOS, {NT_COMANDO, NT_FINLINEA, NT_COMANDOS}},
+    {NT_COMANDOS, {}},
+
+    // comando -> cmdif | cmdwhile | cmdatrib | cmdreturn | llamada
+    {NT_COMANDO, {NT_CMDIF}},
+    {NT_COMANDO, {NT_CMDWHILE}},
+    {NT_COMANDO, {NT_CMDRETURN}},
+    {NT_COMANDO, {A_TOKEN, T_ID, NT_RESTOCOMANDO}},
+    // cmdatrib -> variable '=' exp, llamada -> ID '(' listaexp ')'
+    {NT_RESTOCOMANDO, {A_MARCO, '(', NT_LISTAEXP, ')', A_LLAMADA}},
+    {NT_RESTOCOMANDO, {A_VARIABLE, NT_INDICES, A_TOKEN, '=', NT_EXP, A_ATRIB}},
+
+    // cmdif -> 'if' exp nl bloque { 'else' 'if' exp nl bloque } [ 'else' nl bloque ] 'end'
+    {NT_CMDIF, {A_TOKEN, T_IF, A_MARCO, NT_EXP, NT_FINLINEA, NT_BLOQUE, NT_ELSES, T_END, A_IF}},
+    {NT_ELSES, {T_ELSE, NT_RESTOELSE}},
+    {NT_ELSES, {}},
+    {NT_RESTOELSE, {T_IF, NT_EXP, NT_FINLINEA, NT_BLOQUE, NT_ELSES}},
+    {NT_RESTOELSE, {NT_FINLINEA, NT_BLOQUE}},
+    // cmdwhile -> 'while' exp nl bloque 'loop'
+    {NT_CMDWHILE, {A_TOKEN, T_WHILE, NT_EXP, NT_FINLINEA, NT_BLOQUE, T_LOOP, A_WHILE}},
+    // cmdreturn -> 'return' exp | 'return'
+    {NT_CMDRETURN, {A_TOKEN, T_RETURN, NT_VALORRETORNO}},
+    {NT_VALORRETORNO, {NT_EXP, A_RETURN}},
+    {NT_VALORRETORNO, {A_RETURN_VACIO}},
+
+    // variable -> ID { '[' exp ']' }
+    {NT_INDICES, {A_TOKEN, '[', NT_EXP, ']', A_INDEXAR, NT_INDICES}},
+    {NT_INDICES, {}},
+    // listaexp -> /* vacio */ | exp { ',' exp }
+    {NT_LISTAEXP, {NT_EXP, NT_MASEXP}},
+    {NT_LISTAEXP, {}},
+    {NT_MASEXP, {',', NT_EXP, NT_MASEXP}},
+    {NT_MASEXP, {}},
+
+    // Un no terminal por nivel de precedencia (ver TablaPrecedencia en
+    // parser.cpp): exp -> expand { 'or' expand }, y asi hasta '*' '/'
+    {NT_EXP, {NT_EXPAND, NT_MASOR}},
+    {NT_MASOR, {A_TOKEN, T_OR, NT_EXPAND, A_BINARIA, NT_MASOR}},
+    {NT_MASOR, {}},
+    {NT_EXPAND, {NT_EXPREL, NT_MASAND}},
+    {NT_MASAND, {A_TOKEN, T_AND, NT_EXPREL, A_BINARIA, NT_MASAND}},
+    {NT_MASAND, {}},
+    {NT_EXPREL, {NT_EXPADD, NT_MASREL}},
+    {NT_MASREL, {A_TOKEN, NT_OPREL, NT_EXPADD, A_BINARIA, NT_MASREL}},
+    {NT_MASREL, {}},
+    {NT_OPREL, {'<'}},
+    {NT_OPREL, {'>'}},
+    {NT_OPREL, {T_LE}},
+    {NT_OPREL, {T_GE}},
+    {NT_OPREL, {'='}},
+    {NT_OPREL, {T_NE}},
+    {NT_EXPADD, {NT_EXPMUL, NT_MASADD}},
+    {NT_MASADD, {A_TOKEN, NT_OPADD, NT_EXPMUL, A_BINARIA, NT_MASADD}},
+    {NT_MASADD, {}},
+    {NT_OPADD, {'+'}},
+    {NT_OPADD, {'-'}},
+    {NT_EXPMUL, {NT_UNARIA, NT_MASMUL}},
+    {NT_MASMUL, {A_TOKEN, NT_OPMUL, NT_UNARIA, A_BINARIA, NT_MASMUL}},
+    {NT_MASMUL, {}},
+    {NT_OPMUL, {'*'}},
+    {NT_OPMUL, {'/'}},
+    {NT_UNARIA, {A_TOKEN, NT_OPUNARIO, NT_UNARIA, A_UNARIA}},
+    {NT_UNARIA, {NT_FACTOR}},
+    {NT_OPUNARIO, {T_NOT}},
+    {NT_OPUNARIO, {'-'}},
+
+    // factor -> literal | 'new' '[' exp ']' tipo | '(' exp ')' | llamada | variable
+    {NT_FACTOR, {A_TOKEN, NT_LITERAL, A_LITERAL}},
+    {NT_FACTOR, {A_TOKEN, T_NEW, '[', NT_EXP, ']', NT_TIPO, A_NEW}},
+    {NT_FACTOR, {'(', NT_EXP, ')'}},
+    {NT_FACTOR, {A_TOKEN, T_ID, NT_RESTOFACTOR}},
+    {NT_LITERAL, {T_LITNUMERAL}},
+    {NT_LITERAL, {T_LITSTRING}},
+    {NT_LITERAL, {T_TRUE}},
+    {NT_LITERAL, {T_FALSE}},
+    {NT_RESTOFACTOR, {A_MARCO, '(', NT_LISTAEXP, ')', A_LLAMADA}},
+    {NT_RESTOFACTOR, {A_VARIABLE, NT_INDICES}},
+};
+
+const size_t CANTIDAD_PRODUCCIONES = sizeof(PRODUCCIONES) / sizeof(PRODUCCIONES[0]);
+
+// ============================================================
+// Conjuntos de tokens
+// ============================================================
+
+struct ConjuntoTokens {
+    uint64_t bits[4] = {};
+
+    constexpr bool contiene(int token) const {
+        return (bits[(uint8_t)token >> 6] >> (token & 63)) & 1;
+    }
+    constexpr void agregar(int token) {
+        bits[(uint8_t)token >> 6] |= (uint64_t)1 << (token & 63);
+    }
+    // Agrega los de otro; devuelve si cambio
+    constexpr bool unir(const ConjuntoTokens& otro) {
+        bool cambio = false;
+        for (int i = 0; i < 4; i++) {
+            uint64_t nuevos = otro.bits[i] & ~bits[i];
+            bits[i] |= nuevos;
+            cambio = cambio || nuevos != 0;
+        }
+        return cambio;
+    }
+    constexpr bool interseca(const ConjuntoTokens& otro) const {
+        for (int i = 0; i < 4; i++) {
+            if (bits[i] & otro.bits[i]) return true;
+        }
+        return false;
+    }
+    std::vector<int> tokens() const {
+        std::vector<int> lista;
+        for (int t = 0; t < 256; t++) {
+            if (contiene(t)) lista.push_back(t);
+        }
+        return lista;
+    }
+};
+
+// ============================================================
+// FIRST, FOLLOW y tabla LL(1)
+// ============================================================
+
+const uint8_t SIN_PRODUCCION = 0xFF;
+const size_t MAX_COLUMNAS = 64;
+
+static_assert(CANTIDAD_PRODUCCIONES < SIN_PRODUCCION, "demasiadas producciones para la tabla");
+
+struct AnalisisLL1 {
+    bool anulable[CANTIDAD_NO_TERMINALES] = {};
+    ConjuntoTokens primeros[CANTIDAD_NO_TERMINALES] = {};
+    ConjuntoTokens siguientes[CANTIDAD_NO_TERMINALES] = {};
+
+    // La tabla tiene una columna por terminal que aparece en la gramatica
+    // (columna[token]); los demas tokens van a la columna 0, siempre vacia.
+    uint8_t columna[256] = {};
+    size_t columnas = 1;
+    uint8_t tabla[CANTIDAD_NO_TERMINALES][MAX_COLUMNAS] = {};
+
+    int conflictos = 0;         // celdas con mas de una produccion
+    int inconsistencias = 0;    // producciones cuyo efecto en las pilas no cuadra
+
+    constexpr uint8_t produccion(Simbolo noTerminal, int token) const {
+        return tabla[noTerminal - PRIMER_NO_TERMINAL][columna[(uint8_t)token]];
+    }
+};
+
+// FIRST de derecha[desde..] (las acciones se saltean); devuelve si es anulable
+constexpr bool primerosDeSecuencia(const AnalisisLL1& a, const Produccion& p, size_t desde,
+                                   ConjuntoTokens& resultado) {
+    for (size_t i = desde; i < p.longitud; i++) {
+        Simbolo s = p.derecha[i];
+        if (esTerminal(s)) {
+            resultado.agregar(s);
+            return false;
+        }
+        if (esNoTerminal(s)) {
+            resultado.unir(a.primeros[s - PRIMER_NO_TERMINAL]);
+            if (!a.anulable[s - PRIMER_NO_TERMINAL]) return false;
+        }
+    }
+    return true;
+}
+
+// Simula las acciones y no terminales de la produccion sobre las pilas del
+// analizador y verifica que dejen lo que declara su lado izquierdo: asi la
+// recuperacion de errores, que saca un no terminal sin expandirlo, puede
+// compensar con NO_TERMINALES[].valores y .tokens.
+constexpr bool produccionConsistente(const Produccion& p) {
+    const NoTerminalInfo& izq = NO_TERMINALES[p.izquierda - PRIMER_NO_TERMINAL];
+    int valores[MAX_DERECHA + 1] = {};    // nodos apilados en cada marco abierto
+    int marco = 0;
+    int tokens = 0;
+    bool variable = false;                // aparece una lista fuera de un marco
+    for (size_t i = 0; i < p.longitud; i++) {
+        Simbolo s = p.derecha[i];
+        if (esAccion(s)) {
+            const AccionInfo& a = ACCIONES[s - PRIMERA_ACCION];
+            tokens += a.tokens;
+            if (a.marcos > 0) {
+                valores[++marco] = 0;
+            } else if (a.marcos < 0) {
+                if (marco == 0) return false;
+                valores[--marco] += 1;
+            } else {
+                valores[marco] += a.valores;
+            }
+        } else if (esNoTerminal(s)) {
+            const NoTerminalInfo& n = NO_TERMINALES[s - PRIMER_NO_TERMINAL];
+            tokens += n.tokens;
+            if (n.valores == VALORES_VARIABLES) {
+                variable = variable || marco == 0;
+            } else {
+                valores[marco] += n.valores;
+            }
+        }
+    }
+    if (marco != 0 || tokens != izq.tokens) return false;
+    if (izq.valores == VALORES_VARIABLES) return true;
+    return !variable && valores[0] == izq.valores;
+}
+
+constexpr AnalisisLL1 construirAnalisisLL1() {
+    AnalisisLL1 a;
+
+    // Anulables y FIRST, hasta el punto fijo
+    for (bool cambio = true; cambio;) {
+        cambio = false;
+        for (const Produccion& p : PRODUCCIONES) {
+            size_t n = p.izquierda - PRIMER_NO_TERMINAL;
+            ConjuntoTokens primeros;
+            bool anulable = primerosDeSecuencia(a, p, 0, primeros);
+            cambio = a.primeros[n].unir(primeros) || cambio;
+            if (anulable && !a.anulable[n]) {
+                a.anulable[n] = true;
+                cambio = true;
+            }
+        }
+    }
+
+    // FOLLOW: lo que puede seguir a cada no terminal del lado derecho
+    a.siguientes[NT_PROGRAMA - PRIMER_NO_TERMINAL].agregar(T_EOF);
+    for (bool cambio = true; cambio;) {
+        cambio = false;
+        for (const Produccion& p : PRODUCCIONES) {
+            for (size_t i = 0; i < p.longitud; i++) {
+                if (!esNoTerminal(p.derecha[i])) continue;
+                ConjuntoTokens siguientes;
+                if (primerosDeSecuencia(a, p, i + 1, siguientes)) {
+                    siguientes.unir(a.siguientes[p.izquierda - PRIMER_NO_TERMINAL]);
+                }
+                cambio = a.siguientes[p.derecha[i] - PRIMER_NO_TERMINAL].unir(siguientes) || cambio;
+            }
+        }
+    }
+
+    // Columnas: T_EOF y cada terminal de la gramatica
+    a.columna[T_EOF] = (uint8_t)a.columnas++;
+    for (const Produccion& p : PRODUCCIONES) {
+        for (size_t i = 0; i < p.longitud; i++) {
+            Simbolo s = p.derecha[i];
+            if (esTerminal(s) && a.columna[s] == 0 && a.columnas < MAX_COLUMNAS) {
+                a.columna[s] = (uint8_t)a.columnas++;
+            }
+        }
+    }
+
+    // Tabla: cada produccion va en las columnas de su FIRST, y si es
+    // anulable tambien en las del FOLLOW de su lado izquierdo
+    for (size_t n = 0; n < CANTIDAD_NO_TERMINALES; n++) {
+        for (size_t c = 0; c < MAX_COLUMNAS; c++) {
+            a.tabla[n][c] = SIN_PRODUCCION;
+        }
+    }
+    for (size_t k = 0; k < CANTIDAD_PRODUCCIONES; k++) {
+        const Produccion& p = PRODUCCIONES[k];
+        size_t n = p.izquierda - PRIMER_NO_TERMINAL;
+        ConjuntoTokens seleccion;
+        if (primerosDeSecuencia(a, p, 0, seleccion)) {
+            seleccion.unir(a.siguientes[n]);
+        }
+        for (int t = 0; t < 256; t++) {
+            if (!seleccion.contiene(t)) continue;
+            uint8_t& celda = a.tabla[n][a.columna[t]];
+            if (celda != SIN_PRODUCCION && celda != k) {
+                a.conflictos++;
+            }
+            celda = (uint8_t)k;
+        }
+        if (!produccionConsistente(p)) {
+            a.inconsistencias++;
+        }
+    }
+
+    // El fin de archivo tambien cierra la ultima linea (como nl() en
+    // parser.cpp): donde no hay produccion para T_EOF se usa la de T_NL, y
+    // el analizador da por visto un T_NL esperado al final de la entrada
+    for (size_t n = 0; n < CANTIDAD_NO_TERMINALES; n++) {
+        uint8_t& fin = a.tabla[n][a.columna[T_EOF]];
+        if (fin == SIN_PRODUCCION) {
+            fin = a.tabla[n][a.columna[T_NL]];
+        }
+    }
+    return a;
+}
+
+constexpr AnalisisLL1 ANALISIS_LL1 = construirAnalisisLL1();
+
+static_assert(ANALISIS_LL1.columnas <= MAX_COLUMNAS, "demasiados terminales para la tabla");
+static_assert(ANALISIS_LL1.conflictos == 0, "la gramatica de Mini-0 no es LL(1)");
+static_assert(ANALISIS_LL1.inconsistencias == 0,
+              "una produccion no deja en las pilas lo que declara su no terminal");
+
+constexpr const ConjuntoTokens& primerosDe(NoTerminal n) {
+    return ANALISIS_LL1.primeros[n - PRIMER_NO_TERMINAL];
+}
+
+constexpr const ConjuntoTokens& siguientesDe(NoTerminal n) {
+    return ANALISIS_LL1.siguientes[n - PRIMER_NO_TERMINAL];
+}
+
+// ============================================================
+// Conjuntos de sincronizacion
+// ============================================================
+// Tokens donde el analizador descendente retoma despues de un error,
+// siempre con T_EOF. Una declaracion se retoma al comienzo de la siguiente
+// o en el salto de linea que la termina; un comando, en lo que sigue a un
+// comando o al bloque que lo contiene; una expresion, en lo que la sigue.
+
+constexpr ConjuntoTokens construirSincronizacion(std::initializer_list<ConjuntoTokens> partes) {
+    ConjuntoTokens conjunto;
+    conjunto.agregar(T_EOF);
+    for (const ConjuntoTokens& parte : partes) {
+        conjunto.unir(parte);
+    }
+    return conjunto;
+}
+
+constexpr ConjuntoTokens SINCRONIZACION_DECL = construirSincronizacion(
+    {primerosDe(NT_DECL), siguientesDe(NT_DECL), primerosDe(NT_FINLINEA)});
+constexpr ConjuntoTokens SINCRONIZACION_COMANDO = construirSincronizacion(
+    {siguientesDe(NT_COMANDO), siguientesDe(NT_BLOQUE)});
+constexpr ConjuntoTokens SINCRONIZACION_EXP = construirSincronizacion(
+    {siguientesDe(NT_EXP)});
+
+// Vuelca las producciones, los conjuntos FIRST y FOLLOW y el tamano de la
+// tabla (--gramatica)
+void imprimirGramatica(std::ostream& salida);
+
+#endif
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cstring>
+#include "incremental.h"
+#include "tokens.h"
+
+using namespace std;
+
+// Con menos nodos que esto no vale la pena analizar todo para liberar la
+// arena de las declaraciones reemplazadas
+static const size_t MINIMO_NODOS_DESCARTADOS = 4096;
+
+// ============================================================
+// Analisis por declaraciones
+// ============================================================
+
+// Nodo N_PROGRAMA con los nodos de las declaraciones. Si la cantidad no
+// cambio se reescriben los hijos del anterior en vez de crear otro.
+static void armarPrograma(Documento& doc) {
+    Ast& ast = doc.ctx.ast;
+    uint32_t cantidad = 0;
+    for (const DeclAnalizada& d : doc.decls) {
+        cantidad += d.nodo != NODO_NULO;
+    }
+    if (ast.raiz != NODO_NULO && ast.nodo(ast.raiz).cantidadHijos == cantidad) {
+        uint32_t i = 0;
+        for (const DeclAnalizada& d : doc.decls) {
+            if (d.nodo != NODO_NULO) {
+                ast.fijarHijo(ast.raiz, i++, d.nodo);
+            }
+        }
+        return;
+    }
+    size_t desde = ast.pila.size();
+    for (const DeclAnalizada& d : doc.decls) {
+        if (d.nodo != NODO_NULO) {
+            ast.apilar(d.nodo);
+        }
+    }
+    ast.raiz = ast.crear(N_PROGRAMA, 0, 0, 0, desde);
+}
+
+static void analizarCompleto(Documento& doc) {
+    ParserContext& ctx = doc.ctx;
+    ctx.flujo = nullptr;
+    ctx.retenerAst = true;
+    ctx.interner.limpiar();
+    tokenizar(ctx.tokens, ctx.interner, doc.texto.data(), doc.longitud());
+    iniciarParser(ctx);
+    doc.decls.clear();
+
+    skipNL(ctx);
+    if (ctx.lookahead == T_EOF) {
+        iniciarParser(ctx);
+        programa(ctx);      // sin declaraciones: solo reporta el error
+    } else {
+        analizarDeclaraciones(ctx, doc.decls, [](size_t) { return false; });
+        armarPrograma(doc);
+    }
+
+    doc.ultimo = Reanalisis();
+    doc.ultimo.tokensLexados = ctx.tokens.cantidad();
+    doc.ultimo.declaracionesAnalizadas = doc.decls.size();
+    doc.ultimo.completo = true;
+}
+
+void abrirDocumento(Documento& doc, const char* datos, size_t longitud) {
+    doc.texto.assign(datos, datos + longitud);
+    doc.texto.push_back('\0');
+    doc.texto.push_back('\0');
+    analizarCompleto(doc);
+}
+
+// ============================================================
+// Edicion
+// ============================================================
+
+// Reemplaza v[desde, hasta) por nuevos moviendo la cola una sola vez
+template <typename T>
+static void reemplazarRango(vector<T>& v, size_t desde, size_t hasta, const vector<T>& nuevos) {
+    size_t viejos = hasta - desde;
+    if (nuevos.size() > viejos) {
+        v.insert(v.begin() + hasta, nuevos.size() - viejos, T());
+    } else {
+        v.erase(v.begin() + desde + nuevos.size(), v.begin() + hasta);
+    }
+    copy(nuevos.begin(), nuevos.end(), v.begin() + desde);
+}
+
+bool editarDocumento(Documento& doc, const Edicion& edicion) {
+    size_t inicio = edicion.inicio;
+    size_t finViejo = edicion.fin;
+    if (inicio > finViejo || finViejo > doc.longitud()) {
+        return false;
+    }
+    size_t finNuevo = inicio + edicion.texto.size();
+    // Corrimiento de lo que sigue a la edicion, en bytes (modulo 2^32 si achica)
+    uint32_t delta = (uint32_t)(finNuevo - finViejo);
+
+    ParserContext& ctx = doc.ctx;
+    TokenBuffer& t = ctx.tokens;
+    Ast& ast = ctx.ast;
+
+    // La fuente se edita en su lugar; los offsets viejos siguen validos
+    // antes de inicio y corridos en delta desde finViejo
+    size_t viejos = finViejo - inicio;
+    if (edicion.texto.size() > viejos) {
+        doc.texto.insert(doc.texto.begin() + finViejo, edicion.texto.size() - viejos, '\0');
+    } else {
+        doc.texto.erase(doc.texto.begin() + finNuevo, doc.texto.begin() + finViejo);
+    }
+    memcpy(doc.texto.data() + inicio, edicion.texto.data(), edicion.texto.size());
+    t.fuente = doc.texto.data();
+    t.longitudFuente = doc.longitud();
+    reemplazarEnIndice(ctx.lineas, t.fuente, inicio, finViejo, finNuevo);
+
+    if (doc.decls.empty()) {
+        analizarCompleto(doc);      // programa vacio: no hay nada que reusar
+        return true;
+    }
+    if (ctx.maximoErrores > 0) {
+        // Donde se detiene depende de los errores de todo lo anterior
+        analizarCompleto(doc);
+        return true;
+    }
+
+    // Se vuelve a lexar desde el primer token de la ultima declaracion que
+    // empieza antes de la edicion: ahi el lexer esta en su estado inicial y
+    // ningun token anterior llega hasta el texto editado
+    auto despues = partition_point(doc.decls.begin(), doc.decls.end(),
+                                   [&](const DeclAnalizada& d) {
+                                       return t.offsets[d.primerToken] < inicio;
+                                   });
+    long contiene = (long)(despues - doc.decls.begin()) - 1;
+    size_t primerToken = contiene >= 0 ? doc.decls[contiene].primerToken : 0;
+    size_t inicioLexer = contiene >= 0 ? t.offsets[primerToken] : 0;
+
+    // Hasta que aparezca, pasado el texto nuevo, un token igual a uno viejo
+    // en la misma posicion (corrida): desde ahi el lexer, en su estado
+    // inicial sobre el mismo texto, repetiria exactamente los viejos
+    vector<uint8_t> tipos;
+    vector<uint32_t> offsets, longitudes, valores;
+    size_t primerCambio = SIZE_MAX;     // primer token distinto del viejo en ese indice
+    size_t viejo = primerToken;
+    bool sincronizado = false;
+
+    LexerEstado estado;
+    estado.interner = &ctx.interner;
+    yyscan_t scanner = lexerDesdeMemoria(doc.texto.data() + inicioLexer,
+                                         doc.longitud() - inicioLexer, &estado);
+    int token;
+    do {
+        token = yylex(scanner);
+        uint32_t offset = (uint32_t)inicioLexer + estado.offset;
+        uint32_t valor = 0;
+        if (token == T_LITNUMERAL) {
+            valor = (uint32_t)estado.valor.num;
+        } else if (token == T_ID || token == T_LITSTRING) {
+            valor = estado.valor.sym;
+        }
+        if (token == T_EOF && tipos.empty()) {
+            // T_EOF va al final del ultimo token, que quedo antes del tramo
+            offset = primerToken > 0 ? t.offsets[primerToken - 1] + t.longitudes[primerToken - 1]
+                                     : 0;
+        }
+
+        if (offset >= finNuevo) {
+            uint32_t buscado = offset - delta;
+            while (viejo < t.cantidad() && t.offsets[viejo] < buscado) {
+                viejo++;
+            }
+            if (viejo < t.cantidad() && t.offsets[viejo] == buscado &&
+                t.tipos[viejo] == token && t.longitudes[viejo] == estado.longitud) {
+                sincronizado = true;
+                break;
+            }
+        }
+        if (primerCambio == SIZE_MAX) {
+            size_t i = primerToken + tipos.size();
+            uint32_t anterior = i < t.cantidad() ? t.offsets[i] : 0;
+            if (anterior >= finViejo) {
+                anterior += delta;
+            }
+            if (i >= t.cantidad() || t.tipos[i] != token || anterior != offset ||
+                t.longitudes[i] != estado.longitud || t.valores[i] != valor) {
+                primerCambio = i;
+            }
+        }
+        tipos.push_back((uint8_t)token);
+        offsets.push_back(offset);
+        longitudes.push_back(estado.longitud);
+        valores.push_back(valor);
+    } while (token != T_EOF);
+    restaurarBuffer(scanner);
+    yylex_destroy(scanner);
+
+    // Los tokens [primerToken, finReemplazo) se reemplazan por los nuevos;
+    // los que siguen solo se corren
+    size_t finReemplazo = sincronizado ? viejo : t.cantidad();
+    size_t finCambio = primerToken + tipos.size();
+    long deltaTokens = (long)finCambio - (long)finReemplazo;
+    reemplazarRango(t.tipos, primerToken, finReemplazo, tipos);
+    reemplazarRango(t.offsets, primerToken, finReemplazo, offsets);
+    reemplazarRango(t.longitudes, primerToken, finReemplazo, longitudes);
+    reemplazarRango(t.valores, primerToken, finReemplazo, valores);
+    if (delta != 0) {
+        for (size_t i = finCambio; i < t.cantidad(); i++) {
+            t.offsets[i] += delta;
+        }
+    }
+
+    // Se analiza desde la declaracion que contiene la edicion, o desde la
+    // anterior si cambio el primer token de esta: la anterior lo vio como
+    // lookahead al terminar
+    long reinicio = contiene;
+    if (contiene >= 0 && primerCambio <= primerToken) {
+        reinicio--;
+    }
+    size_t primeraDecl = reinicio >= 0 ? (size_t)reinicio : 0;
+    size_t primerError = reinicio >= 0 ? doc.decls[reinicio].primerError : 0;
+    vector<ErrorInfo> erroresViejos(ctx.errores.begin() + primerError, ctx.errores.end());
+    ctx.errores.resize(primerError);
+    bool detenidoAntes = ctx.detenido;
+
+    ctx.posToken = reinicio >= 0 ? doc.decls[reinicio].primerToken : 0;
+    ctx.lookahead = t.tipos[ctx.posToken];
+    ctx.profundidad = 0;
+    ctx.detenido = false;
+    if (reinicio < 0) {
+        skipNL(ctx);
+        if (ctx.lookahead == T_EOF) {
+            analizarCompleto(doc);
+            return true;
+        }
+    }
+
+    // Una declaracion vieja se reusa, con todas las que le siguen, si
+    // empieza donde el analisis nuevo va a empezar una, despues de los
+    // tokens que cambiaron: el parser solo mira el lookahead, asi que su
+    // resultado depende solo de los tokens desde ahi
+    size_t candidata = reinicio + 1;
+    auto puedeReusar = [&](size_t p) {
+        if (!sincronizado || p < finCambio) {
+            return false;
+        }
+        size_t buscado = (size_t)((long)p - deltaTokens);
+        while (candidata < doc.decls.size() && doc.decls[candidata].primerToken < buscado) {
+            candidata++;
+        }
+        return candidata < doc.decls.size() && doc.decls[candidata].primerToken == buscado;
+    };
+    vector<DeclAnalizada> nuevas;
+    bool reusa = analizarDeclaraciones(ctx, nuevas, puedeReusar);
+    size_t primeraReusada = reusa ? candidata : doc.decls.size();
+
+    // Declaraciones, nodos y errores conservados: corridos en tokens y bytes
+    if (reusa) {
+        uint32_t errorViejo = doc.decls[primeraReusada].primerError;
+        long deltaErrores = (long)ctx.errores.size() - (long)errorViejo;
+        for (size_t i = primeraReusada; i < doc.decls.size(); i++) {
+            DeclAnalizada& d = doc.decls[i];
+            d.primerToken = (uint32_t)((long)d.primerToken + deltaTokens);
+            d.primerError = (uint32_t)((long)d.primerError + deltaErrores);
+            if (delta != 0) {
+                for (uint32_t n = d.primerNodo; n < d.primerNodo + d.cantidadNodos; n++) {
+                    ast.nodos[n].offset += delta;
+                }
+            }
+        }
+        for (size_t i = errorViejo - primerError; i < erroresViejos.size(); i++) {
+            ErrorInfo& e = erroresViejos[i];
+            e.token = (uint32_t)((long)e.token + deltaTokens);
+            e.offset = t.offsets[e.token];
+            Posicion pos = ubicarToken(ctx.lineas, t, e.token);
+            e.linea = pos.linea;
+            e.columna = pos.columna;
+            ctx.errores.push_back(e);
+        }
+        ctx.detenido = detenidoAntes;
+    }
+    doc.decls.erase(doc.decls.begin() + primeraDecl, doc.decls.begin() + primeraReusada);
+    doc.decls.insert(doc.decls.begin() + primeraDecl, nuevas.begin(), nuevas.end());
+    ctx.hayErrores = !ctx.errores.empty();
+    armarPrograma(doc);
+
+    doc.ultimo = Reanalisis();
+    doc.ultimo.tokensLexados = tipos.size() + (sincronizado ? 1 : 0);
+    doc.ultimo.declaracionesAnalizadas = nuevas.size();
+    doc.ultimo.declaracionesReusadas = doc.decls.size() - nuevas.size();
+
+    // Los nodos de las declaraciones reemplazadas siguen en la arena
+    size_t vivos = 1;
+    for (const DeclAnalizada& d : doc.decls) {
+        vivos += d.cantidadNodos;
+    }
+    if (ast.cantidad() > 2 * vivos + MINIMO_NODOS_DESCARTADOS) {
+        analizarCompleto(doc);
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parser.h"
+
+// Reemplazo de los bytes [inicio, fin) de la fuente por texto
+struct Edicion {
+    size_t inicio;
+    size_t fin;
+    std::string texto;
+};
+
+// Lo que hizo la ultima edicion
+struct Reanalisis {
+    size_t tokensLexados = 0;
+    size_t declaracionesAnalizadas = 0;
+    size_t declaracionesReusadas = 0;
+    bool completo = false;  // se analizo todo el archivo de nuevo
+};
+
+// Archivo abierto en un editor. Se analiza completo al abrirlo y despues
+// cada edicion vuelve a lexar solo desde el comienzo de la declaracion de
+// nivel superior que la contiene hasta que el flujo de tokens coincide con
+// el anterior, y vuelve a analizar solo desde esa declaracion hasta la
+// primera que empiece donde empezaba una de antes. Las demas (sus tokens,
+// nodos y errores) se conservan, corridas en bytes y en tokens.
+//
+// ctx queda como despues de programa() sobre el texto completo: mismos
+// tokens, mismo arbol (salvo los ids de los nodos) y mismos errores. Usa
+// siempre el lexer de flex. Los nodos de las declaraciones reemplazadas
+// quedan en la arena hasta que ocupan mas que el arbol vivo; entonces se
+// analiza todo de nuevo, igual que en cada edicion si hay
+// ctx.maximoErrores. decl() recursa hasta ctx.profundidadMaxima: con
+// un limite mayor al de defecto llamar desde un hilo con pilaNecesaria(ctx).
+struct Documento {
+    std::vector<char> texto;        // fuente seguida de dos '\0' (ver fuente.h)
+    ParserContext ctx;
+    std::vector<DeclAnalizada> decls;
+    Reanalisis ultimo;
+
+    size_t longitud() const { return texto.size() - 2; }
+};
+
+// Carga la fuente y la analiza completa
+void abrirDocumento(Documento& doc, const char* datos, size_t longitud);
+
+// Aplica la edicion y actualiza el analisis. Devuelve false, sin cambiar
+// nada, si el rango no esta dentro de la fuente.
+bool editarDocumento(Documento& doc, const Edicion& edicion);
+
+#endif
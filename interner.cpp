@@ -0,0 +1,82 @@
+#include <cstring>
+#include "interner.h"
+
+static const size_t TAMANO_INICIAL = 1024;
+
+// FNV-1a de 32 bits
+static uint32_t hashTexto(const char* texto, size_t longitud) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < longitud; i++) {
+        h ^= (unsigned char)texto[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+Interner::Interner() {
+    limpiar();
+}
+
+void Interner::limpiar() {
+    arena.clear();
+    inicios.assign(1, 0);
+    hashes.clear();
+    tabla.assign(TAMANO_INICIAL, 0);
+}
+
+// Ranura donde esta (o deberia insertarse) la grafia; sondeo lineal
+uint32_t Interner::ranura(const char* texto, size_t longitud, uint32_t hash) const {
+    uint32_t mascara = (uint32_t)tabla.size() - 1;
+    uint32_t i = hash & mascara;
+    while (tabla[i] != 0) {
+        SimboloId id = tabla[i] - 1;
+        if (hashes[id] == hash && this->longitud(id) == longitud &&
+            memcmp(&arena[inicios[id]], texto, longitud) == 0) {
+            return i;
+        }
+        i = (i + 1) & mascara;
+    }
+    return i;
+}
+
+void Interner::crecer() {
+    tabla.assign(tabla.size() * 2, 0);
+    uint32_t mascara = (uint32_t)tabla.size() - 1;
+    for (SimboloId id = 0; id < cantidad(); id++) {
+        uint32_t i = hashes[id] & mascara;
+        while (tabla[i] != 0) {
+            i = (i + 1) & mascara;
+        }
+        tabla[i] = id + 1;
+    }
+}
+
+SimboloId Interner::internar(const char* texto, size_t longitud) {
+    uint32_t hash = hashTexto(texto, longitud);
+    uint32_t i = ranura(texto, longitud, hash);
+    if (tabla[i] != 0) {
+        return tabla[i] - 1;
+    }
+
+    SimboloId id = (SimboloId)cantidad();
+    arena.insert(arena.end(), texto, texto + longitud);
+    arena.push_back('\0');
+    inicios.push_back((uint32_t)arena.size());
+    hashes.push_back(hash);
+    tabla[i] = id + 1;
+
+    // Factor de carga maximo 1/2
+    if (cantidad() * 2 > tabla.size()) {
+        crecer();
+    }
+    return id;
+}
+
+bool Interner::buscar(const char* texto, size_t longitud, SimboloId& id) const {
+    uint32_t i = ranura(texto, longitud, hashTexto(texto, longitud));
+    if (tabla[i] == 0) {
+        return false;
+    }
+    id = tabla[i] - 1;
+    return true;
+}
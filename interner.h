@@ -0,0 +1,52 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Identificador estable de un simbolo internado (identificador o literal
+// string). Dos apariciones con la misma grafia reciben el mismo id.
+typedef uint32_t SimboloId;
+
+// Tabla de simbolos internados: cada grafia distinta se guarda una sola vez
+// en una arena contigua, terminada en '\0', y se indexa con una tabla hash
+// de direccionamiento abierto.
+class Interner {
+public:
+    Interner();
+
+    // Devuelve el id de la grafia, insertandola si es nueva
+    SimboloId internar(const char* texto, size_t longitud);
+
+    // Busca sin insertar; devuelve false si la grafia no existe
+    bool buscar(const char* texto, size_t longitud, SimboloId& id) const;
+
+    // El puntero es valido hasta la siguiente insercion
+    const char* texto(SimboloId id) const { return &arena[inicios[id]]; }
+    uint32_t longitud(SimboloId id) const { return inicios[id + 1] - inicios[id] - 1; }
+
+    size_t cantidad() const { return inicios.size() - 1; }
+    size_t bytesArena() const { return arena.size(); }
+
+    // Recorre los simbolos en orden de aparicion: f(id, texto, longitud)
+    template <typename F>
+    void recorrer(F f) const {
+        for (SimboloId id = 0; id < cantidad(); id++) {
+            f(id, texto(id), longitud(id));
+        }
+    }
+
+    void limpiar();
+
+private:
+    std::vector<char> arena;        // bytes de todos los simbolos
+    std::vector<uint32_t> inicios;  // inicio de cada simbolo (uno extra al final)
+    std::vector<uint32_t> hashes;   // hash de cada simbolo, para rehash y comparacion
+    std::vector<uint32_t> tabla;    // id + 1 de cada ranura; 0 = vacia
+
+    uint32_t ranura(const char* texto, size_t longitud, uint32_t hash) const;
+    void crecer();
+};
+
+#endif
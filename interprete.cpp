@@ -0,0 +1,633 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "interprete.h"
+#include "posicion.h"
+#include "tokens.h"
+
+// Todos los valores ocupan 32 bits: int, char y bool como numeros, un
+// string como el SimboloId de su literal (con las comillas, asi dos
+// strings iguales tienen el mismo id) y un arreglo como su indice en
+// Maquina::arreglos, donde el 0 es el arreglo nulo
+typedef int32_t Valor;
+
+static const int64_t MINIMO_INT = INT32_MIN;
+static const int64_t MAXIMO_INT = INT32_MAX;
+
+// Ranura de una variable global (en Maquina::globales); las demas son
+// relativas a la base del marco de su funcion
+static const uint32_t RANURA_GLOBAL = 0x80000000u;
+
+enum AccionEjecucion : uint8_t {
+    EJECUTAR,           // un comando
+    EVALUAR,            // una expresion: deja su valor en la pila de valores
+    APLICAR,            // los valores de los hijos ya estan apilados
+    CORTOCIRCUITO,      // 'and' u 'or' con el operando izquierdo evaluado
+    RAMA,               // la condicion extra de un if ya esta evaluada
+    REPETIR,            // la condicion de un while ya esta evaluada
+    ASIGNAR,            // destino y valor de un N_ATRIB evaluados
+    RETORNAR,           // valor de un N_RETURN evaluado
+    DESCARTAR,          // desapila el valor de una llamada usada como comando
+    FIN_FUNCION         // se llego al final del cuerpo sin return
+};
+
+struct Orden {
+    NodoId nodo;
+    uint8_t accion;
+    uint32_t extra;
+};
+
+// Una llamada en curso
+struct Marco {
+    uint32_t base;          // primera ranura en Maquina::locales
+    uint32_t ordenes;       // Maquina::ordenes.size() al entrar: return desapila hasta aca
+};
+
+struct Arreglo {
+    uint32_t inicio;        // en Maquina::elementos
+    uint32_t longitud;
+};
+
+struct Maquina {
+    const ParserContext& ctx;
+    const Semantica& semantica;
+    Ejecucion& ejecucion;
+    // Por nodo: en N_DECLVAR y N_PARAMETRO, su ranura; en N_FUNCION, el
+    // tamano de su marco mas 1 (0 hasta la primera llamada)
+    std::vector<uint32_t> ranura;
+    std::vector<Valor> globales;
+    std::vector<Valor> locales;
+    std::vector<Orden> ordenes;
+    std::vector<Valor> valores;
+    std::vector<Marco> marcos;
+    std::vector<Arreglo> arreglos;
+    std::vector<Valor> elementos;
+    Valor stringVacio;      // el id de "" (aunque no aparezca en el programa)
+};
+
+static bool fallar(Maquina& m, ErrorEjecucion error, NodoId id, int64_t valor = 0,
+                   uint32_t longitud = 0) {
+    m.ejecucion.error = error;
+    m.ejecucion.nodoError = id;
+    m.ejecucion.valorError = valor;
+    m.ejecucion.longitudError = longitud;
+    return false;
+}
+
+static Valor desapilar(Maquina& m) {
+    Valor v = m.valores.back();
+    m.valores.pop_back();
+    return v;
+}
+
+// ============================================================
+// Variables
+// ============================================================
+
+// Valor inicial de una variable del tipo escrito en el N_TIPO id
+static Valor valorInicial(const Maquina& m, NodoId id) {
+    const Nodo& tipo = m.ctx.ast.nodo(id);
+    return tipo.valor == 0 && tipo.op == T_STRING ? m.stringVacio : 0;
+}
+
+// Asigna las ranuras de los parametros y las variables locales de una
+// funcion la primera vez que se la llama. Cada declaracion tiene la suya:
+// las de bloques distintos no comparten.
+static void prepararFuncion(Maquina& m, NodoId funcion) {
+    if (m.ranura[funcion] != 0) {
+        return;
+    }
+    const Ast& ast = m.ctx.ast;
+    uint32_t parametros = ast.nodo(funcion).cantidadHijos - 2;
+    uint32_t siguiente = 0;
+    for (uint32_t i = 0; i < parametros; i++) {
+        m.ranura[ast.hijo(funcion, i)] = siguiente++;
+    }
+    // Las declaraciones solo estan al comienzo de los bloques
+    std::vector<NodoId> pendientes;
+    pendientes.push_back(ast.hijo(funcion, parametros + 1));
+    while (!pendientes.empty()) {
+        NodoId id = pendientes.back();
+        pendientes.pop_back();
+        if (id == NODO_NULO) {
+            continue;
+        }
+        const Nodo& nodo = ast.nodo(id);
+        if (nodo.tipo == N_DECLVAR) {
+            m.ranura[id] = siguiente++;
+        } else if (nodo.tipo == N_BLOQUE || nodo.tipo == N_IF || nodo.tipo == N_WHILE) {
+            for (uint32_t i = nodo.cantidadHijos; i-- > 0;) {
+                pendientes.push_back(ast.hijo(id, i));
+            }
+        }
+    }
+    m.ranura[funcion] = siguiente + 1;
+}
+
+// La variable de un N_VAR, o la que declara un N_DECLVAR local
+static Valor& variable(Maquina& m, NodoId declaracion) {
+    uint32_t r = m.ranura[declaracion];
+    if (r & RANURA_GLOBAL) {
+        return m.globales[r & ~RANURA_GLOBAL];
+    }
+    return m.locales[m.marcos.back().base + r];
+}
+
+static Valor& variableDeUso(Maquina& m, NodoId uso) {
+    return variable(m, m.semantica.declaracion[uso]);
+}
+
+// ============================================================
+// Llamadas
+// ============================================================
+
+// Entra a funcion con sus argumentos en el tope de la pila de valores
+static bool entrar(Maquina& m, NodoId funcion, NodoId llamada, uint32_t argumentos) {
+    if (m.marcos.size() >= MAXIMO_LLAMADAS) {
+        return fallar(m, EJECUCION_LLAMADAS, llamada);
+    }
+    prepararFuncion(m, funcion);
+    uint32_t base = (uint32_t)m.locales.size();
+    m.locales.resize(base + m.ranura[funcion] - 1, 0);
+    // Los parametros ocupan las primeras ranuras, en orden
+    size_t primero = m.valores.size() - argumentos;
+    std::copy(m.valores.begin() + primero, m.valores.end(), m.locales.begin() + base);
+    m.valores.resize(primero);
+
+    m.marcos.push_back(Marco{base, (uint32_t)m.ordenes.size()});
+    m.ejecucion.llamadas++;
+    m.ejecucion.profundidadMaxima = std::max(m.ejecucion.profundidadMaxima, m.marcos.size());
+    const Ast& ast = m.ctx.ast;
+    m.ordenes.push_back({funcion, FIN_FUNCION, 0});
+    NodoId cuerpo = ast.hijo(funcion, ast.nodo(funcion).cantidadHijos - 1);
+    if (cuerpo != NODO_NULO) {
+        m.ordenes.push_back({cuerpo, EJECUTAR, 0});
+    }
+    return true;
+}
+
+// Sale de la funcion actual dejando su valor (0 si no tiene) en la pila
+static void retornar(Maquina& m, bool conValor) {
+    Valor v = conValor ? desapilar(m) : 0;
+    const Marco& marco = m.marcos.back();
+    m.ordenes.resize(marco.ordenes);
+    m.locales.resize(marco.base);
+    m.marcos.pop_back();
+    m.valores.push_back(v);
+}
+
+// ============================================================
+// Operaciones
+// ============================================================
+
+static bool apilarEntero(Maquina& m, NodoId id, int64_t valor) {
+    if (valor < MINIMO_INT || valor > MAXIMO_INT) {
+        return fallar(m, EJECUCION_DESBORDE, id);
+    }
+    m.valores.push_back((Valor)valor);
+    return true;
+}
+
+static bool aplicarBinaria(Maquina& m, NodoId id) {
+    int64_t b = desapilar(m);
+    int64_t a = desapilar(m);
+    switch (m.ctx.ast.nodo(id).op) {
+        case '+': return apilarEntero(m, id, a + b);
+        case '-': return apilarEntero(m, id, a - b);
+        case '*': return apilarEntero(m, id, a * b);
+        case '/':
+            if (b == 0) {
+                return fallar(m, EJECUCION_DIVISION_CERO, id);
+            }
+            return apilarEntero(m, id, a / b);
+        case '<': m.valores.push_back(a < b); return true;
+        case '>': m.valores.push_back(a > b); return true;
+        case T_LE: m.valores.push_back(a <= b); return true;
+        case T_GE: m.valores.push_back(a >= b); return true;
+        // Numeros, bools, strings (por su id) y arreglos (por referencia)
+        case '=': m.valores.push_back(a == b); return true;
+        default: m.valores.push_back(a != b); return true;
+    }
+}
+
+// Desapila el indice y el arreglo de un N_INDEXAR y devuelve la posicion
+// del elemento en Maquina::elementos, o -1 si no existe
+static int64_t elemento(Maquina& m, NodoId indexar) {
+    int64_t i = desapilar(m);
+    Valor a = desapilar(m);
+    if (a == 0) {
+        fallar(m, EJECUCION_ARREGLO_NULO, m.ctx.ast.hijo(indexar, 0));
+        return -1;
+    }
+    const Arreglo& arreglo = m.arreglos[a];
+    if (i < 0 || i >= arreglo.longitud) {
+        fallar(m, EJECUCION_INDICE, m.ctx.ast.hijo(indexar, 1), i, arreglo.longitud);
+        return -1;
+    }
+    return arreglo.inicio + i;
+}
+
+static bool crearArreglo(Maquina& m, NodoId id) {
+    int64_t longitud = desapilar(m);
+    if (longitud < 0) {
+        return fallar(m, EJECUCION_TAMANO, m.ctx.ast.hijo(id, 0), longitud);
+    }
+    if (m.elementos.size() + longitud > MAXIMO_ELEMENTOS) {
+        return fallar(m, EJECUCION_MEMORIA, id);
+    }
+    Valor inicial = valorInicial(m, m.ctx.ast.hijo(id, 1));
+    m.arreglos.push_back(Arreglo{(uint32_t)m.elementos.size(), (uint32_t)longitud});
+    m.elementos.resize(m.elementos.size() + longitud, inicial);
+    m.valores.push_back((Valor)(m.arreglos.size() - 1));
+    return true;
+}
+
+static bool aplicar(Maquina& m, NodoId id) {
+    const Ast& ast = m.ctx.ast;
+    const Nodo& nodo = ast.nodo(id);
+    switch (nodo.tipo) {
+        case N_BINARIA:
+            return aplicarBinaria(m, id);
+        case N_UNARIA: {
+            int64_t v = desapilar(m);
+            if (nodo.op == T_NOT) {
+                m.valores.push_back(!v);
+                return true;
+            }
+            return apilarEntero(m, id, -v);
+        }
+        case N_INDEXAR: {
+            int64_t i = elemento(m, id);
+            if (i < 0) {
+                return false;
+            }
+            m.valores.push_back(m.elementos[i]);
+            return true;
+        }
+        case N_NEW:
+            return crearArreglo(m, id);
+        default:
+            // N_LLAMADA
+            return entrar(m, m.semantica.declaracion[id], id, nodo.cantidadHijos);
+    }
+}
+
+// ============================================================
+// Recorrido
+// ============================================================
+
+// Apila la aplicacion de id y la evaluacion de sus hijos, que salen en orden
+static void apilarOperandos(Maquina& m, NodoId id) {
+    const Ast& ast = m.ctx.ast;
+    m.ordenes.push_back({id, APLICAR, 0});
+    for (uint32_t i = ast.nodo(id).cantidadHijos; i-- > 0;) {
+        m.ordenes.push_back({ast.hijo(id, i), EVALUAR, 0});
+    }
+}
+
+static void evaluar(Maquina& m, NodoId id) {
+    const Ast& ast = m.ctx.ast;
+    const Nodo& nodo = ast.nodo(id);
+    switch (nodo.tipo) {
+        case N_NUMERO: case N_BOOL: case N_STRING:
+            // Un N_NUMERO es un numeral en rango o un resultado del plegado
+            m.valores.push_back((Valor)nodo.valor);
+            return;
+        case N_VAR:
+            m.valores.push_back(variableDeUso(m, id));
+            return;
+        case N_BINARIA:
+            if (nodo.op == T_AND || nodo.op == T_OR) {
+                m.ordenes.push_back({id, CORTOCIRCUITO, 0});
+                m.ordenes.push_back({ast.hijo(id, 0), EVALUAR, 0});
+                return;
+            }
+            apilarOperandos(m, id);
+            return;
+        case N_NEW:
+            // El tipo no se evalua
+            m.ordenes.push_back({id, APLICAR, 0});
+            m.ordenes.push_back({ast.hijo(id, 0), EVALUAR, 0});
+            return;
+        default:
+            // N_UNARIA, N_INDEXAR, N_LLAMADA
+            apilarOperandos(m, id);
+            return;
+    }
+}
+
+static void ejecutarComando(Maquina& m, NodoId id) {
+    const Ast& ast = m.ctx.ast;
+    const Nodo& nodo = ast.nodo(id);
+    switch (nodo.tipo) {
+        case N_BLOQUE:
+            for (uint32_t i = nodo.cantidadHijos; i-- > 0;) {
+                NodoId h = ast.hijo(id, i);
+                if (h != NODO_NULO) {
+                    m.ordenes.push_back({h, EJECUTAR, 0});
+                }
+            }
+            return;
+        case N_DECLVAR:
+            variable(m, id) = valorInicial(m, ast.hijo(id, 0));
+            return;
+        case N_IF:
+            // [cond, bloque, {cond, bloque}, [bloque else]]
+            m.ordenes.push_back({id, RAMA, 0});
+            m.ordenes.push_back({ast.hijo(id, 0), EVALUAR, 0});
+            return;
+        case N_WHILE:
+            m.ordenes.push_back({id, REPETIR, 0});
+            m.ordenes.push_back({ast.hijo(id, 0), EVALUAR, 0});
+            return;
+        case N_RETURN:
+            if (nodo.cantidadHijos == 0) {
+                retornar(m, false);
+                return;
+            }
+            m.ordenes.push_back({id, RETORNAR, 0});
+            m.ordenes.push_back({ast.hijo(id, 0), EVALUAR, 0});
+            return;
+        case N_ATRIB: {
+            // [destino, exp]: en a[i] = e se evaluan a, i y e
+            NodoId destino = ast.hijo(id, 0);
+            NodoId valor = ast.hijo(id, 1);
+            bool indexado = ast.nodo(destino).tipo == N_INDEXAR;
+            if (valor == NODO_NULO && !indexado) {
+                return;
+            }
+            m.ordenes.push_back({id, ASIGNAR, 0});
+            if (valor != NODO_NULO) {
+                m.ordenes.push_back({valor, EVALUAR, 0});
+            }
+            if (indexado) {
+                m.ordenes.push_back({ast.hijo(destino, 1), EVALUAR, 0});
+                m.ordenes.push_back({ast.hijo(destino, 0), EVALUAR, 0});
+            }
+            return;
+        }
+        default:
+            // N_LLAMADA como comando
+            m.ordenes.push_back({id, DESCARTAR, 0});
+            apilarOperandos(m, id);
+            return;
+    }
+}
+
+static bool asignar(Maquina& m, NodoId atrib) {
+    const Ast& ast = m.ctx.ast;
+    NodoId destino = ast.hijo(atrib, 0);
+    bool conValor = ast.hijo(atrib, 1) != NODO_NULO;
+    Valor v = conValor ? desapilar(m) : 0;
+    if (ast.nodo(destino).tipo == N_VAR) {
+        variableDeUso(m, destino) = v;
+        return true;
+    }
+    // 'a[i]' sin '=' solo verifica el indice
+    int64_t i = elemento(m, destino);
+    if (i < 0) {
+        return false;
+    }
+    if (conValor) {
+        m.elementos[i] = v;
+    }
+    return true;
+}
+
+// La condicion de la rama extra del if ya esta en la pila
+static void elegirRama(Maquina& m, NodoId id, uint32_t rama) {
+    const Ast& ast = m.ctx.ast;
+    uint32_t hijos = ast.nodo(id).cantidadHijos;
+    if (desapilar(m)) {
+        m.ordenes.push_back({ast.hijo(id, rama + 1), EJECUTAR, 0});
+        return;
+    }
+    uint32_t siguiente = rama + 2;
+    if (siguiente + 1 < hijos) {
+        m.ordenes.push_back({id, RAMA, siguiente});
+        m.ordenes.push_back({ast.hijo(id, siguiente), EVALUAR, 0});
+    } else if (siguiente < hijos) {
+        m.ordenes.push_back({ast.hijo(id, siguiente), EJECUTAR, 0});
+    }
+}
+
+static bool ejecutar(Maquina& m) {
+    const Ast& ast = m.ctx.ast;
+    Ejecucion& ejecucion = m.ejecucion;
+    while (!m.ordenes.empty()) {
+        Orden o = m.ordenes.back();
+        m.ordenes.pop_back();
+        switch (o.accion) {
+            case EJECUTAR: case EVALUAR:
+                ejecucion.pasos++;
+                if (ejecucion.maximoPasos > 0 && ejecucion.pasos > ejecucion.maximoPasos) {
+                    return fallar(m, EJECUCION_PASOS, o.nodo);
+                }
+                if (o.accion == EJECUTAR) {
+                    ejecutarComando(m, o.nodo);
+                } else {
+                    evaluar(m, o.nodo);
+                }
+                break;
+            case APLICAR:
+                if (!aplicar(m, o.nodo)) {
+                    return false;
+                }
+                break;
+            case CORTOCIRCUITO: {
+                // Si el izquierdo decide, es el resultado; si no, lo es el derecho
+                Valor izq = m.valores.back();
+                if (izq == (ast.nodo(o.nodo).op == T_OR)) {
+                    break;
+                }
+                m.valores.pop_back();
+                m.ordenes.push_back({ast.hijo(o.nodo, 1), EVALUAR, 0});
+                break;
+            }
+            case RAMA:
+                elegirRama(m, o.nodo, o.extra);
+                break;
+            case REPETIR:
+                if (desapilar(m)) {
+                    m.ordenes.push_back({o.nodo, EJECUTAR, 0});
+                    m.ordenes.push_back({ast.hijo(o.nodo, 1), EJECUTAR, 0});
+                }
+                break;
+            case ASIGNAR:
+                if (!asignar(m, o.nodo)) {
+                    return false;
+                }
+                break;
+            case RETORNAR:
+                retornar(m, true);
+                break;
+            case DESCARTAR:
+                m.valores.pop_back();
+                break;
+            case FIN_FUNCION: {
+                // [parametro..., retorno, bloque]
+                const Nodo& funcion = ast.nodo(o.nodo);
+                if (ast.hijo(o.nodo, funcion.cantidadHijos - 2) != NODO_NULO) {
+                    return fallar(m, EJECUCION_SIN_RETORNO, o.nodo);
+                }
+                retornar(m, false);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+// ============================================================
+// Programa
+// ============================================================
+
+// Agrega a salida el valor v del tipo escrito en el N_TIPO tipo (con
+// dimensiones menos los '[]' ya recorridos)
+static void escribirValor(const Maquina& m, const Nodo& tipo, uint32_t dimensiones, Valor v,
+                          std::string& salida) {
+    if (dimensiones > 0) {
+        if (v == 0) {
+            salida += "(arreglo nulo)";
+            return;
+        }
+        const Arreglo& arreglo = m.arreglos[v];
+        salida += '[';
+        for (uint32_t i = 0; i < arreglo.longitud; i++) {
+            if (i > 0) salida += ", ";
+            escribirValor(m, tipo, dimensiones - 1, m.elementos[arreglo.inicio + i], salida);
+        }
+        salida += ']';
+        return;
+    }
+    const Interner& interner = m.ctx.interner;
+    switch (tipo.op) {
+        case T_BOOL:
+            salida += v ? "true" : "false";
+            return;
+        case T_STRING:
+            if (v == m.stringVacio) {
+                salida += "\"\"";
+            } else {
+                salida.append(interner.texto(v), interner.longitud(v));
+            }
+            return;
+        default:
+            salida += std::to_string(v);
+            return;
+    }
+}
+
+bool ejecutarPrograma(const ParserContext& ctx, const Semantica& semantica,
+                      Ejecucion& ejecucion) {
+    const Ast& ast = ctx.ast;
+    Maquina m{ctx, semantica, ejecucion, {}, {}, {}, {}, {}, {}, {}, {}, -1};
+    SimboloId vacio;
+    if (ctx.interner.buscar("\"\"", 2, vacio)) {
+        m.stringVacio = (Valor)vacio;
+    }
+    m.ranura.assign(ast.cantidad(), 0);
+    m.arreglos.push_back(Arreglo{0, 0});    // el nulo
+
+    // Globales y main, que no recibe parametros
+    NodoId principal = NODO_NULO;
+    const Nodo& programa = ast.nodo(ast.raiz);
+    for (uint32_t i = 0; i < programa.cantidadHijos; i++) {
+        NodoId d = ast.hijo(ast.raiz, i);
+        const Nodo& nodo = ast.nodo(d);
+        if (nodo.tipo == N_DECLVAR) {
+            m.ranura[d] = RANURA_GLOBAL | (uint32_t)m.globales.size();
+            m.globales.push_back(valorInicial(m, ast.hijo(d, 0)));
+        } else if (nodo.cantidadHijos == 2 && ctx.interner.longitud(nodo.valor) == 4 &&
+                   memcmp(ctx.interner.texto(nodo.valor), "main", 4) == 0) {
+            principal = d;
+        }
+    }
+    if (principal == NODO_NULO) {
+        return fallar(m, EJECUCION_SIN_MAIN, NODO_NULO);
+    }
+
+    entrar(m, principal, principal, 0);
+    bool bien = ejecutar(m);
+    ejecucion.elementos = m.elementos.size();
+    if (!bien) {
+        return false;
+    }
+    ejecucion.valor = m.valores.back();
+    NodoId retorno = ast.hijo(principal, 0);
+    ejecucion.resultado.clear();
+    if (retorno == NODO_NULO) {
+        ejecucion.resultado = "(ninguno)";
+    } else {
+        const Nodo& tipo = ast.nodo(retorno);
+        escribirValor(m, tipo, tipo.valor, ejecucion.valor, ejecucion.resultado);
+    }
+    return true;
+}
+
+void escribirErrorEjecucion(ParserContext& ctx, const Ejecucion& ejecucion,
+                            std::string& salida) {
+    salida += "Error de ejecucion";
+    if (ejecucion.nodoError != NODO_NULO) {
+        const Nodo& nodo = ctx.ast.nodo(ejecucion.nodoError);
+        Posicion pos = ubicarToken(ctx.lineas, ctx.tokens, tokenEn(ctx, nodo.offset));
+        salida += " [Linea ";
+        salida += std::to_string(pos.linea);
+        salida += ", columna ";
+        salida += std::to_string(pos.columna);
+        salida += ']';
+    }
+    salida += ": ";
+    switch (ejecucion.error) {
+        case EJECUCION_CORRECTA:
+            salida += "ninguno";
+            break;
+        case EJECUCION_SIN_MAIN:
+            salida += "El programa no tiene una funcion main sin parametros";
+            break;
+        case EJECUCION_DIVISION_CERO:
+            salida += "Division por cero";
+            break;
+        case EJECUCION_DESBORDE:
+            salida += "El resultado no entra en int";
+            break;
+        case EJECUCION_ARREGLO_NULO:
+            salida += "Se indexa un arreglo que no se creo con new";
+            break;
+        case EJECUCION_INDICE:
+            salida += "Indice ";
+            salida += std::to_string(ejecucion.valorError);
+            salida += " fuera de un arreglo de ";
+            salida += std::to_string(ejecucion.longitudError);
+            salida += ejecucion.longitudError == 1 ? " elemento" : " elementos";
+            break;
+        case EJECUCION_TAMANO:
+            salida += "new con tamano negativo (";
+            salida += std::to_string(ejecucion.valorError);
+            salida += ')';
+            break;
+        case EJECUCION_MEMORIA:
+            salida += "Los arreglos superan los ";
+            salida += std::to_string(MAXIMO_ELEMENTOS);
+            salida += " elementos";
+            break;
+        case EJECUCION_SIN_RETORNO: {
+            const Nodo& funcion = ctx.ast.nodo(ejecucion.nodoError);
+            salida += '\'';
+            salida.append(ctx.interner.texto(funcion.valor), ctx.interner.longitud(funcion.valor));
+            salida += "' termino sin return";
+            break;
+        }
+        case EJECUCION_LLAMADAS:
+            salida += "Mas de ";
+            salida += std::to_string(MAXIMO_LLAMADAS);
+            salida += " llamadas anidadas";
+            break;
+        case EJECUCION_PASOS:
+            salida += "Se supero el maximo de ";
+            salida += std::to_string(ejecucion.maximoPasos);
+            salida += " pasos";
+            break;
+    }
+    salida += '\n';
+}
@@ -0,0 +1,68 @@
+#ifndef INTERPRETE_H
+#define INTERPRETE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "parser.h"
+#include "semantico.h"
+
+// Errores de ejecucion
+enum ErrorEjecucion : uint8_t {
+    EJECUCION_CORRECTA,
+    EJECUCION_SIN_MAIN,             // no hay 'fun main()' sin parametros
+    EJECUCION_DIVISION_CERO,
+    EJECUCION_DESBORDE,             // un resultado de int fuera de rango
+    EJECUCION_ARREGLO_NULO,         // se indexa una variable de arreglo sin new
+    EJECUCION_INDICE,               // indice fuera del arreglo
+    EJECUCION_TAMANO,               // new con tamano negativo
+    EJECUCION_MEMORIA,              // se supero MAXIMO_ELEMENTOS
+    EJECUCION_SIN_RETORNO,          // una funcion con tipo termino sin return
+    EJECUCION_LLAMADAS,             // se supero MAXIMO_LLAMADAS anidadas
+    EJECUCION_PASOS                 // se supero Ejecucion::maximoPasos
+};
+
+// Llamadas anidadas permitidas: la recursion del programa no usa la pila
+// del proceso, pero sin limite una recursion infinita agota la memoria
+const size_t MAXIMO_LLAMADAS = 1 << 20;
+// Elementos de todos los arreglos creados con new (no se liberan)
+const size_t MAXIMO_ELEMENTOS = (size_t)1 << 28;
+
+// Una ejecucion de ejecutarPrograma: el limite que recibe y lo que deja
+struct Ejecucion {
+    uint64_t maximoPasos = 0;       // 0 = sin limite
+    ErrorEjecucion error = EJECUCION_CORRECTA;
+    NodoId nodoError = NODO_NULO;   // donde ocurrio (el operador, el indice, la llamada...)
+    int64_t valorError = 0;         // el indice o el tamano que fallo
+    uint32_t longitudError = 0;     // la del arreglo, con EJECUCION_INDICE
+    int32_t valor = 0;              // lo que devolvio main (int, char o bool)
+    std::string resultado;          // lo que devolvio main como se escribe en Mini-0
+    uint64_t pasos = 0;             // nodos ejecutados o evaluados
+    uint64_t llamadas = 0;
+    size_t profundidadMaxima = 0;   // llamadas anidadas, contando main
+    size_t elementos = 0;           // de los arreglos creados
+};
+
+// Interprete de referencia: ejecuta main() recorriendo ctx.ast. Supone un
+// programa sin errores (verificarPrograma, que tambien rechaza los
+// numerales que no entran en int) y usa los vinculos de
+// semantica.declaracion; con o sin el plegado de constantes da lo mismo.
+// El recorrido es iterativo, con pilas propias de ordenes, valores y
+// llamadas, asi que ni la recursion del programa ni el anidamiento de las
+// expresiones usan la pila del proceso.
+// Semantica: int de 32 bits con signo, y desbordar o dividir por cero es
+// un error (como en el plegado); char se comporta como int. 'and' y 'or'
+// evaluan el operando derecho solo si hace falta. Los argumentos y los
+// operandos se evaluan de izquierda a derecha; en 'a[i] = e', a, i y e en
+// ese orden. Cada variable empieza en 0, false, "" o un arreglo nulo, y las
+// de un bloque vuelven a ese valor cada vez que se entra al bloque. Los
+// arreglos se pasan por referencia y no se liberan.
+// Devuelve false si la ejecucion termino con un error (ejecucion.error).
+bool ejecutarPrograma(const ParserContext& ctx, const Semantica& semantica,
+                      Ejecucion& ejecucion);
+
+// "Error de ejecucion [Linea L, columna C]: <mensaje>"
+void escribirErrorEjecucion(ParserContext& ctx, const Ejecucion& ejecucion,
+                            std::string& salida);
+
+#endif
@@ -0,0 +1,280 @@
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "lexersimd.h"
+#include "tokenbuffer.h"
+#include "interner.h"
+#include "tokens.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LEXER_SSE2 1
+#endif
+
+// ============================================================
+// Clasificacion de bloques de 32 bytes
+// ============================================================
+// Cada funcion devuelve una mascara con el bit i encendido si el byte i
+// del bloque pertenece a la clase. Un bloque son dos cargas de 16 bytes
+// (SSE2 esta en todo x86-64, sin flags de compilacion especiales). Solo se
+// clasifican bloques completos dentro de la fuente; el resto se recorre
+// byte a byte, asi nunca se lee despues del final del buffer.
+
+static const size_t BLOQUE = 32;
+
+#ifdef LEXER_SSE2
+// Bytes en [desde, desde + cantidad) como comparacion sin signo, usando la
+// comparacion con signo de SSE2 sobre el valor desplazado
+static inline __m128i enRango(__m128i v, unsigned char desde, unsigned char cantidad) {
+    __m128i t = _mm_add_epi8(v, _mm_set1_epi8((char)(128 - desde)));
+    return _mm_cmplt_epi8(t, _mm_set1_epi8((char)(-128 + cantidad)));
+}
+
+static inline __m128i igual(__m128i v, char c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+static inline uint32_t mascara(__m128i bajo, __m128i alto) {
+    return (uint32_t)_mm_movemask_epi8(bajo) | ((uint32_t)_mm_movemask_epi8(alto) << 16);
+}
+
+static inline __m128i cargar(const char* p) {
+    return _mm_loadu_si128((const __m128i*)p);
+}
+
+// [ \t\r]
+static inline __m128i claseEspacio(__m128i v) {
+    return _mm_or_si128(_mm_or_si128(igual(v, ' '), igual(v, '\t')), igual(v, '\r'));
+}
+
+// [ \t]
+static inline __m128i claseSangria(__m128i v) {
+    return _mm_or_si128(igual(v, ' '), igual(v, '\t'));
+}
+
+// [a-zA-Z0-9_]
+static inline __m128i claseIdentificador(__m128i v) {
+    __m128i letra = enRango(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26);
+    return _mm_or_si128(_mm_or_si128(letra, enRango(v, '0', 10)), igual(v, '_'));
+}
+
+// [0-9]
+static inline __m128i claseDigito(__m128i v) {
+    return enRango(v, '0', 10);
+}
+
+// [0-9a-fA-F]
+static inline __m128i claseHex(__m128i v) {
+    __m128i letra = enRango(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 6);
+    return _mm_or_si128(letra, enRango(v, '0', 10));
+}
+
+#define MASCARA(clase, p) mascara(clase(cargar(p)), clase(cargar((p) + 16)))
+#define MASCARA_IGUAL(p, c) mascara(igual(cargar(p), c), igual(cargar((p) + 16), c))
+#endif
+
+static inline bool esIdentificador(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool esDigito(unsigned char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool esHex(unsigned char c) {
+    return esDigito(c) || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+// Avanza mientras los bytes pertenezcan a la clase
+#ifdef LEXER_SSE2
+#define DEFINIR_SALTO(nombre, clase, escalar)                           \
+    static inline const char* nombre(const char* p, const char* fin) { \
+        while (p + BLOQUE <= fin) {                                     \
+            uint32_t fuera = ~MASCARA(clase, p);                        \
+            if (fuera != 0) return p + __builtin_ctz(fuera);            \
+            p += BLOQUE;                                                \
+        }                                                               \
+        while (p < fin && escalar((unsigned char)*p)) p++;              \
+        return p;                                                       \
+    }
+#else
+#define DEFINIR_SALTO(nombre, clase, escalar)                           \
+    static inline const char* nombre(const char* p, const char* fin) { \
+        while (p < fin && escalar((unsigned char)*p)) p++;              \
+        return p;                                                       \
+    }
+#endif
+
+static inline bool esEspacio(unsigned char c) { return c == ' ' || c == '\t' || c == '\r'; }
+static inline bool esSangria(unsigned char c) { return c == ' ' || c == '\t'; }
+
+DEFINIR_SALTO(saltarEspacios, claseEspacio, esEspacio)
+DEFINIR_SALTO(saltarSangria, claseSangria, esSangria)
+DEFINIR_SALTO(saltarIdentificador, claseIdentificador, esIdentificador)
+DEFINIR_SALTO(saltarDigitos, claseDigito, esDigito)
+DEFINIR_SALTO(saltarHex, claseHex, esHex)
+
+// Fin de un comentario de linea: el '\n' siguiente (sin consumirlo) o el
+// final de la fuente
+static inline const char* finDeLinea(const char* p, const char* fin) {
+    const void* nl = memchr(p, '\n', fin - p);
+    return nl ? (const char*)nl : fin;
+}
+
+// Cuerpo de un comentario de bloque a partir de p (despues de "/*").
+// Devuelve el byte siguiente a "*/", o nullptr si el comentario no se
+// cierra.
+static const char* finDeComentario(const char* p, const char* fin) {
+#ifdef LEXER_SSE2
+    // Se compara el bloque en p contra el bloque en p + 1 para ubicar "*/"
+    while (p + BLOQUE + 1 <= fin) {
+        uint32_t cierre = MASCARA_IGUAL(p, '*') & MASCARA_IGUAL(p + 1, '/');
+        if (cierre != 0) {
+            return p + __builtin_ctz(cierre) + 2;
+        }
+        p += BLOQUE;
+    }
+#endif
+    while (p < fin) {
+        if (*p == '*' && p + 1 < fin && p[1] == '/') {
+            return p + 2;
+        }
+        p++;
+    }
+    return nullptr;
+}
+
+// Cuerpo de un string a partir de p (despues de la comilla inicial), con
+// la misma semantica que \"([^\"\\]|\\.)*\" y su variante sin cerrar:
+// devuelve la comilla de cierre, o la posicion donde termina el prefijo
+// valido (una '\' seguida de '\n' o del final, o el final de la fuente).
+static const char* finDeString(const char* p, const char* fin) {
+    for (;;) {
+#ifdef LEXER_SSE2
+        while (p + BLOQUE <= fin) {
+            uint32_t corte = MASCARA_IGUAL(p, '"') | MASCARA_IGUAL(p, '\\');
+            if (corte != 0) {
+                p += __builtin_ctz(corte);
+                break;
+            }
+            p += BLOQUE;
+        }
+#endif
+        while (p < fin && *p != '"' && *p != '\\') {
+            p++;
+        }
+        if (p >= fin || *p == '"') {
+            return p;
+        }
+        // '\' escapa cualquier caracter salvo '\n'
+        if (p + 1 >= fin || p[1] == '\n') {
+            return p;
+        }
+        p += 2;
+    }
+}
+
+// ============================================================
+// Tokens
+// ============================================================
+
+// Valor de un literal numerico, igual que las acciones de mini.l (atoi y
+// strtol sobre el lexema terminado en '\0')
+static uint32_t valorNumero(const char* p, size_t n, bool hex) {
+    char corto[32];
+    std::string largo;
+    const char* texto;
+    if (n < sizeof(corto)) {
+        memcpy(corto, p, n);
+        corto[n] = '\0';
+        texto = corto;
+    } else {
+        largo.assign(p, n);
+        texto = largo.c_str();
+    }
+    int valor = hex ? (int)strtol(texto, NULL, 16) : atoi(texto);
+    return (uint32_t)valor;
+}
+
+void tokenizarSimd(TokenBuffer& tokens, Interner& interner, char* fuente, size_t longitud) {
+    tokens.limpiar();
+    tokens.fuente = fuente;
+    tokens.longitudFuente = longitud;
+    tokens.reservar(longitud);
+
+    const char* p = fuente;
+    const char* fin = fuente + longitud;
+    const char* finToken = fuente;  // fin del ultimo token (offset de T_EOF)
+
+    // Igual que RETURN_TOKEN
+    #define EMITIR(tipo, inicio, fin_, valor) do {                                  \
+        finToken = (fin_);                                                          \
+        tokens.agregar((tipo), (uint32_t)((inicio) - fuente),                        \
+                       (uint32_t)((fin_) - (inicio)), (valor));                      \
+    } while (0)
+
+    while (p < fin) {
+        const char* inicio = p;
+        unsigned char c = (unsigned char)*p;
+
+        if (c == ' ' || c == '\t' || c == '\r') {
+            p = saltarEspacios(p, fin);
+        } else if (c == '\n') {
+            p = saltarSangria(p + 1, fin);
+            EMITIR(T_NL, inicio, p, 0);
+        } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') {
+            p = saltarIdentificador(p + 1, fin);
+            int tipo = buscarPalabraReservada(inicio, p - inicio);
+            uint32_t valor = tipo == T_ID ? interner.internar(inicio, p - inicio) : 0;
+            EMITIR(tipo, inicio, p, valor);
+        } else if (c == '_') {
+            p = saltarIdentificador(p + 1, fin);
+            EMITIR(T_ID, inicio, p, interner.internar(inicio, p - inicio));
+        } else if (esDigito(c)) {
+            bool hex = c == '0' && p + 2 < fin && (p[1] | 0x20) == 'x' && esHex((unsigned char)p[2]);
+            p = hex ? saltarHex(p + 2, fin) : saltarDigitos(p + 1, fin);
+            EMITIR(T_LITNUMERAL, inicio, p, valorNumero(inicio, p - inicio, hex));
+        } else if (c == '"') {
+            p = finDeString(p + 1, fin);
+            int tipo = T_ERROR;
+            if (p < fin && *p == '"') {
+                p++;
+                tipo = T_LITSTRING;
+            }
+            // El string sin cerrar tambien se interna, como en mini.l, para
+            // que los ids de los simbolos siguientes coincidan
+            uint32_t valor = interner.internar(inicio, p - inicio);
+            EMITIR(tipo, inicio, p, tipo == T_LITSTRING ? valor : 0);
+        } else if (c == '/' && p + 1 < fin && p[1] == '/') {
+            p = finDeLinea(p + 2, fin);
+        } else if (c == '/' && p + 1 < fin && p[1] == '*') {
+            p = finDeComentario(p + 2, fin);
+            if (p == nullptr) {
+                // <COMMENT_BLOCK><<EOF>>: T_ERROR sin lexema al final
+                EMITIR(T_ERROR, fin, fin, 0);
+                break;
+            }
+        } else {
+            int tipo = T_ERROR;
+            p++;
+            switch (c) {
+                case '>':
+                    if (p < fin && *p == '=') { p++; tipo = T_GE; } else { tipo = '>'; }
+                    break;
+                case '<':
+                    if (p < fin && *p == '=') { p++; tipo = T_LE; }
+                    else if (p < fin && *p == '>') { p++; tipo = T_NE; }
+                    else { tipo = '<'; }
+                    break;
+                case '(': case ')': case ',': case ':': case '=':
+                case '[': case ']': case '+': case '-': case '*': case '/':
+                    tipo = c;
+                    break;
+            }
+            EMITIR(tipo, inicio, p, 0);
+        }
+    }
+
+    #undef EMITIR
+    tokens.agregar(T_EOF, (uint32_t)(finToken - fuente), 0, 0);
+}
@@ -0,0 +1,18 @@
+#ifndef LEXERSIMD_H
+#define LEXERSIMD_H
+
+#include <cstddef>
+
+struct TokenBuffer;
+class Interner;
+
+// Lexer escrito a mano, alternativo al DFA de flex (--lexer=simd). Reconoce
+// el mismo lenguaje que mini.l y produce exactamente el mismo flujo de
+// tokens (tipos, offsets, longitudes, valores e ids del interner),
+// pero salta espacios, comentarios, identificadores, numeros y cuerpos de
+// strings clasificando bloques de 32 bytes con SSE2 en vez de un byte por
+// transicion. mini.l sigue siendo la referencia: --comparar-lexers corre
+// ambos y reporta la primera diferencia.
+void tokenizarSimd(TokenBuffer& tokens, Interner& interner, char* fuente, size_t longitud);
+
+#endif
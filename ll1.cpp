@@ -0,0 +1,407 @@
+#include <cstring>
+#include <vector>
+#include "parser.h"
+#include "gramatica.h"
+#include "tokens.h"
+
+using namespace std;
+
+// ============================================================
+// Analizador de tabla LL(1)
+// ============================================================
+// Una sola iteracion sobre una pila explicita de simbolos: un terminal se
+// compara con el lookahead, un no terminal se reemplaza por la produccion
+// que indica ANALISIS_LL1 y una accion construye nodos del arbol. La pila
+// vive en el heap, asi que el anidamiento solo esta limitado por la memoria.
+
+// La tabla LL(1) expandida: para cada celda (no terminal, columna), lo que
+// queda en la pila despues de reemplazar una y otra vez el primer simbolo
+// que no es accion por su produccion para ese mismo lookahead, hasta que el
+// primero sea un terminal. Asi una expresion no pasa por los ocho niveles
+// de exp ... factor de a uno: toda la cadena se apila de una vez, ya
+// invertida. Si la cadena pasa MAX_EXPANSION simbolos la celda se deja con
+// la produccion sola. Ademas cada @token seguido de un terminal se funde
+// con el en un solo simbolo TERMINAL_GUARDADO + token.
+const size_t MAX_EXPANSION = 32;
+const Simbolo TERMINAL_GUARDADO = 1024;
+static_assert(FIN_ACCIONES <= TERMINAL_GUARDADO, "TERMINAL_GUARDADO se superpone con las acciones");
+const size_t CAPACIDAD_EXPANSIONES = 8192;
+const uint8_t SIN_EXPANSION = 0xFF;
+
+struct Expansiones {
+    Simbolo simbolos[CAPACIDAD_EXPANSIONES] = {};
+    uint16_t inicio[CANTIDAD_NO_TERMINALES][MAX_COLUMNAS] = {};
+    uint8_t longitud[CANTIDAD_NO_TERMINALES][MAX_COLUMNAS] = {};
+    size_t usados = 0;
+    bool desborde = false;
+};
+
+constexpr size_t expandir(Simbolo noTerminal, size_t columna, Simbolo (&cadena)[MAX_EXPANSION]) {
+    uint8_t k = ANALISIS_LL1.tabla[noTerminal - PRIMER_NO_TERMINAL][columna];
+    const Produccion& p = PRODUCCIONES[k];
+    size_t n = p.longitud;
+    for (size_t i = 0; i < n; i++) {
+        cadena[i] = p.derecha[i];
+    }
+    for (;;) {
+        size_t i = 0;
+        while (i < n && esAccion(cadena[i])) i++;
+        if (i == n || esTerminal(cadena[i])) {
+            return n;
+        }
+        uint8_t siguiente = ANALISIS_LL1.tabla[cadena[i] - PRIMER_NO_TERMINAL][columna];
+        if (siguiente == SIN_PRODUCCION) {
+            return n;       // error: lo resuelve la recuperacion al llegar ahi
+        }
+        const Produccion& q = PRODUCCIONES[siguiente];
+        if (n - 1 + q.longitud > MAX_EXPANSION) {
+            // Cadena demasiado larga: solo la produccion de la celda
+            for (size_t j = 0; j < p.longitud; j++) {
+                cadena[j] = p.derecha[j];
+            }
+            return p.longitud;
+        }
+        // Reemplaza cadena[i] por el lado derecho de q
+        Simbolo resto[MAX_EXPANSION] = {};
+        for (size_t j = i + 1; j < n; j++) resto[j - i - 1] = cadena[j];
+        size_t cantidadResto = n - i - 1;
+        for (size_t j = 0; j < q.longitud; j++) cadena[i + j] = q.derecha[j];
+        for (size_t j = 0; j < cantidadResto; j++) cadena[i + q.longitud + j] = resto[j];
+        n = i + q.longitud + cantidadResto;
+    }
+}
+
+constexpr Expansiones construirExpansiones() {
+    Expansiones e;
+    for (size_t n = 0; n < CANTIDAD_NO_TERMINALES; n++) {
+        for (size_t c = 0; c < MAX_COLUMNAS; c++) {
+            e.longitud[n][c] = SIN_EXPANSION;
+            if (ANALISIS_LL1.tabla[n][c] == SIN_PRODUCCION) continue;
+            Simbolo cadena[MAX_EXPANSION] = {};
+            size_t largo = expandir((Simbolo)(PRIMER_NO_TERMINAL + n), c, cadena);
+            size_t fundidos = 0;
+            for (size_t i = 0; i < largo; i++) {
+                if (cadena[i] == A_TOKEN && i + 1 < largo && esTerminal(cadena[i + 1])) {
+                    cadena[fundidos++] = (Simbolo)(TERMINAL_GUARDADO + cadena[++i]);
+                } else {
+                    cadena[fundidos++] = cadena[i];
+                }
+            }
+            largo = fundidos;
+            if (e.usados + largo > CAPACIDAD_EXPANSIONES) {
+                e.desborde = true;
+                return e;
+            }
+            e.inicio[n][c] = (uint16_t)e.usados;
+            e.longitud[n][c] = (uint8_t)largo;
+            for (size_t i = largo; i > 0; i--) {
+                e.simbolos[e.usados++] = cadena[i - 1];
+            }
+        }
+    }
+    return e;
+}
+
+constexpr Expansiones EXPANSIONES = construirExpansiones();
+static_assert(!EXPANSIONES.desborde, "CAPACIDAD_EXPANSIONES no alcanza");
+
+// Token ya consumido que necesita una accion posterior
+struct TokenGuardado {
+    int tipo;
+    uint32_t offset;
+    uint32_t valor;
+};
+
+// Simbolos por reconocer, con el tope al final. Crece de a duplicar y no
+// inicializa lo que se apila (vector::resize llenaria con ceros).
+struct PilaSimbolos {
+    vector<Simbolo> datos = vector<Simbolo>(256);
+    size_t tope = 0;
+
+    bool vacia() const { return tope == 0; }
+    Simbolo sacar() { return datos[--tope]; }
+    void poner(Simbolo s) {
+        reservar(1);
+        datos[tope++] = s;
+    }
+    void poner(const Simbolo* simbolos, size_t cantidad) {
+        reservar(cantidad);
+        memcpy(datos.data() + tope, simbolos, cantidad * sizeof(Simbolo));
+        tope += cantidad;
+    }
+    void reservar(size_t cantidad) {
+        if (tope + cantidad > datos.size()) {
+            datos.resize(2 * datos.size() + cantidad);
+        }
+    }
+};
+
+struct EstadoLL1 {
+    PilaSimbolos simbolos;
+    vector<TokenGuardado> guardados;
+    vector<size_t> marcos;              // inicio de cada marco en Ast::pila
+    Ast::Marca marcaDecl{0, 0};         // arena al empezar la declaracion en curso
+    uint32_t dimensiones = 0;           // '[' ']' del tipo en curso
+};
+
+static inline NodoId desapilar(Ast& ast) {
+    NodoId id = ast.pila.back();
+    ast.pila.pop_back();
+    return id;
+}
+
+static inline TokenGuardado desapilarToken(EstadoLL1& e) {
+    TokenGuardado t = e.guardados.back();
+    e.guardados.pop_back();
+    return t;
+}
+
+static inline size_t cerrarMarco(EstadoLL1& e) {
+    size_t desde = e.marcos.back();
+    e.marcos.pop_back();
+    return desde;
+}
+
+static inline void guardarToken(const ParserContext& ctx, EstadoLL1& e) {
+    e.guardados.push_back(TokenGuardado{ctx.lookahead, ctx.tokens.offsets[ctx.posToken],
+                                        ctx.tokens.valores[ctx.posToken]});
+}
+
+static void ejecutarAccion(ParserContext& ctx, EstadoLL1& e, Simbolo accion) {
+    Ast& ast = ctx.ast;
+    switch (accion) {
+        case A_MARCO:
+            e.marcos.push_back(ast.pila.size());
+            break;
+        case A_TOKEN:
+            guardarToken(ctx, e);
+            break;
+        case A_NULO:
+            ast.apilar(NODO_NULO);
+            break;
+        case A_PROGRAMA:
+            ast.apilar(ast.crear(N_PROGRAMA, 0, 0, 0, cerrarMarco(e)));
+            break;
+        case A_INICIO_DECL:
+            e.marcaDecl = ast.marca();
+            break;
+        case A_FIN_DECL: {
+            // Como en programa(): sin retenerAst la declaracion se libera
+            NodoId d = desapilar(ast);
+            if (!ctx.retenerAst) {
+                ast.liberarHasta(e.marcaDecl);
+            } else if (d != NODO_NULO) {
+                ast.apilar(d);
+            }
+            break;
+        }
+        case A_FUNCION: {
+            size_t desde = cerrarMarco(e);
+            TokenGuardado nombre = desapilarToken(e);
+            ast.apilar(ast.crear(N_FUNCION, 0, nombre.offset, nombre.valor, desde));
+            break;
+        }
+        case A_PARAMETRO:
+        case A_DECLVAR: {
+            NodoId t = desapilar(ast);
+            TokenGuardado nombre = desapilarToken(e);
+            ast.apilar(ast.unario(accion == A_PARAMETRO ? N_PARAMETRO : N_DECLVAR, 0,
+                                  nombre.offset, nombre.valor, t));
+            break;
+        }
+        case A_DIMENSION:
+            e.dimensiones++;
+            break;
+        case A_TIPO: {
+            TokenGuardado base = desapilarToken(e);
+            TokenGuardado inicio = desapilarToken(e);
+            bool esTipo = base.tipo == T_INT || base.tipo == T_BOOL ||
+                          base.tipo == T_CHAR || base.tipo == T_STRING;
+            ast.apilar(ast.hoja(N_TIPO, esTipo ? base.tipo : 0, inicio.offset, e.dimensiones));
+            e.dimensiones = 0;
+            break;
+        }
+        case A_BLOQUE: {
+            size_t desde = cerrarMarco(e);
+            ast.apilar(ast.crear(N_BLOQUE, 0, desapilarToken(e).offset, 0, desde));
+            break;
+        }
+        case A_IF: {
+            size_t desde = cerrarMarco(e);
+            ast.apilar(ast.crear(N_IF, 0, desapilarToken(e).offset, 0, desde));
+            break;
+        }
+        case A_WHILE: {
+            NodoId cuerpo = desapilar(ast);
+            NodoId condicion = desapilar(ast);
+            ast.apilar(ast.binario(N_WHILE, 0, desapilarToken(e).offset, condicion, cuerpo));
+            break;
+        }
+        case A_RETURN: {
+            NodoId valor = desapilar(ast);
+            ast.apilar(ast.unario(N_RETURN, 0, desapilarToken(e).offset, 0, valor));
+            break;
+        }
+        case A_RETURN_VACIO:
+            ast.apilar(ast.hoja(N_RETURN, 0, desapilarToken(e).offset, 0));
+            break;
+        case A_LLAMADA: {
+            size_t desde = cerrarMarco(e);
+            TokenGuardado nombre = desapilarToken(e);
+            ast.apilar(ast.crear(N_LLAMADA, 0, nombre.offset, nombre.valor, desde));
+            break;
+        }
+        case A_VARIABLE: {
+            TokenGuardado nombre = desapilarToken(e);
+            ast.apilar(ast.hoja(N_VAR, 0, nombre.offset, nombre.valor));
+            break;
+        }
+        case A_INDEXAR: {
+            NodoId indice = desapilar(ast);
+            NodoId arreglo = desapilar(ast);
+            ast.apilar(ast.binario(N_INDEXAR, 0, desapilarToken(e).offset, arreglo, indice));
+            break;
+        }
+        case A_ATRIB: {
+            NodoId valor = desapilar(ast);
+            NodoId destino = desapilar(ast);
+            ast.apilar(ast.binario(N_ATRIB, 0, desapilarToken(e).offset, destino, valor));
+            break;
+        }
+        case A_BINARIA: {
+            NodoId der = desapilar(ast);
+            NodoId izq = desapilar(ast);
+            TokenGuardado op = desapilarToken(e);
+            ast.apilar(ast.binario(N_BINARIA, op.tipo, op.offset, izq, der));
+            break;
+        }
+        case A_UNARIA: {
+            NodoId operando = desapilar(ast);
+            TokenGuardado op = desapilarToken(e);
+            ast.apilar(ast.unario(N_UNARIA, op.tipo, op.offset, 0, operando));
+            break;
+        }
+        case A_LITERAL: {
+            TokenGuardado t = desapilarToken(e);
+            switch (t.tipo) {
+                case T_LITNUMERAL: ast.apilar(ast.hoja(N_NUMERO, 0, t.offset, t.valor)); break;
+                case T_LITSTRING:  ast.apilar(ast.hoja(N_STRING, 0, t.offset, t.valor)); break;
+                case T_TRUE:       ast.apilar(ast.hoja(N_BOOL, 0, t.offset, 1)); break;
+                case T_FALSE:      ast.apilar(ast.hoja(N_BOOL, 0, t.offset, 0)); break;
+                default:           ast.apilar(ast.hoja(N_ERROR, 0, t.offset, 0)); break;
+            }
+            break;
+        }
+        case A_NEW: {
+            NodoId t = desapilar(ast);
+            NodoId tamano = desapilar(ast);
+            ast.apilar(ast.binario(N_NEW, 0, desapilarToken(e).offset, tamano, t));
+            break;
+        }
+    }
+}
+
+// Tokens que terminan una linea o un bloque, o empiezan una funcion. Un
+// error nunca los descarta: se abandona el no terminal y lo resuelve el
+// que corresponda mas abajo en la pila, como hacen los SYNC_* de parser.cpp.
+constexpr ConjuntoTokens construirAnclas() {
+    ConjuntoTokens anclas;
+    anclas.unir(primerosDe(NT_FINLINEA));
+    anclas.unir(siguientesDe(NT_BLOQUE));
+    anclas.unir(primerosDe(NT_FUNCION));
+    return anclas;
+}
+
+// Conjunto de sincronizacion de cada no terminal: su FOLLOW y las anclas.
+// Las anclas no valen para los que solo puede seguir el fin de archivo (las
+// declaraciones de mas afuera): abandonarlos terminaria el analisis antes
+// de tiempo.
+struct Sincronizacion {
+    ConjuntoTokens conjunto[CANTIDAD_NO_TERMINALES];
+};
+
+constexpr Sincronizacion construirSincronizacion() {
+    Sincronizacion s;
+    ConjuntoTokens anclas = construirAnclas();
+    for (size_t n = 0; n < CANTIDAD_NO_TERMINALES; n++) {
+        ConjuntoTokens fin;
+        fin.agregar(T_EOF);
+        bool soloFin = !fin.unir(ANALISIS_LL1.siguientes[n]);
+        s.conjunto[n] = fin;
+        if (!soloFin) {
+            s.conjunto[n].unir(anclas);
+        }
+    }
+    return s;
+}
+
+constexpr Sincronizacion SINCRONIZACION = construirSincronizacion();
+
+// Recuperacion en modo panico ante un no terminal sin produccion para el
+// lookahead: se descartan tokens hasta uno que lo empiece (y se reintenta)
+// o hasta uno de su conjunto de sincronizacion (y se da por reconocido,
+// compensando las pilas con lo que habria dejado). Solo se informa el
+// primer error hasta el proximo token reconocido, para no encadenar errores.
+static void recuperar(ParserContext& ctx, EstadoLL1& e, Simbolo noTerminal, bool& recuperando) {
+    const NoTerminalInfo& info = NO_TERMINALES[noTerminal - PRIMER_NO_TERMINAL];
+    if (!recuperando) {
+        errorSintactico(ctx, info.esperado);
+        recuperando = true;
+    }
+    if (SINCRONIZACION.conjunto[noTerminal - PRIMER_NO_TERMINAL].contiene(ctx.lookahead)) {
+        for (int i = 0; i < info.valores; i++) {
+            ctx.ast.apilar(NODO_NULO);
+        }
+        e.guardados.resize(e.guardados.size() + info.tokens);
+    } else {
+        e.simbolos.poner(noTerminal);
+        avanzar(ctx);
+    }
+}
+
+NodoId programaLL1(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    EstadoLL1 e;
+    bool recuperando = false;
+
+    e.simbolos.poner(T_EOF);
+    e.simbolos.poner(NT_PROGRAMA);
+    while (!e.simbolos.vacia()) {
+        Simbolo s = e.simbolos.sacar();
+        if (s >= TERMINAL_GUARDADO) {
+            guardarToken(ctx, e);
+            s -= TERMINAL_GUARDADO;
+        }
+
+        if (esNoTerminal(s)) {
+            size_t n = s - PRIMER_NO_TERMINAL;
+            size_t columna = ANALISIS_LL1.columna[(uint8_t)ctx.lookahead];
+            size_t cantidad = EXPANSIONES.longitud[n][columna];
+            if (cantidad == SIN_EXPANSION) {
+                recuperar(ctx, e, s, recuperando);
+                continue;
+            }
+            e.simbolos.poner(EXPANSIONES.simbolos + EXPANSIONES.inicio[n][columna], cantidad);
+        } else if (esTerminal(s)) {
+            if (s == ctx.lookahead) {
+                if (s != T_EOF) {
+                    avanzar(ctx);
+                }
+                recuperando = false;
+            } else if (s == T_NL && ctx.lookahead == T_EOF) {
+                // el fin de archivo cierra la ultima linea
+            } else {
+                // Se da por insertado el terminal que falta
+                if (!recuperando) {
+                    errorSintactico(ctx, nombreToken(s));
+                    recuperando = true;
+                }
+            }
+        } else {
+            ejecutarAccion(ctx, e, s);
+        }
+    }
+
+    ast.raiz = ast.pila.empty() ? NODO_NULO : desapilar(ast);
+    return ast.raiz;
+}
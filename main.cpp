@@ -1,12 +1,63 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <cerrno>
+#include <climits>
+#include <chrono>
+#include <functional>
 #include "tokens.h"
 #include "parser.h"
+#include "fuente.h"
+#include "interner.h"
+#include "tokenbuffer.h"
+#include "pool.h"
+#include "lexersimd.h"
+#include "flujo.h"
+#include "gramatica.h"
+#include "incremental.h"
+#include "paralelo.h"
+#include "diagnosticos.h"
+#include "analizador.h"
+#include "servidor.h"
+#include "interprete.h"
 
-extern int lookahead;
-extern FILE* yyin;
-int yylex();
+struct Opciones {
+    bool usarMmap = true;
+    bool estadisticas = false;
+    // --lexer=simd, --parser=ll1, --max-profundidad=N, --max-errores=N y
+    // los hilos del parser y del semantico de un archivo (con --paralelo)
+    OpcionesAnalisis analisis;
+    bool compararLexers = false;
+    bool mostrarAst = false;        // --ast: volcar el arbol si no hay errores
+    unsigned hilos = 0;             // 0 = hilosPorDefecto()
+    bool paralelo = false;          // --paralelo: partir un archivo grande entre los hilos
+    bool conEdiciones = false;      // --ediciones=lista
+    std::vector<Edicion> ediciones;
+    FormatoDiagnosticos diagnosticos = DIAGNOSTICOS_TEXTO;  // --diagnosticos=texto|jsonl|sarif
+    bool ejecutar = false;          // --ejecutar (o --run): correr main si no hay errores
+    uint64_t maximoPasos = 0;       // --max-pasos=N; 0 = sin limite
+    // Con --servidor cada pedido corre en el directorio y con la entrada
+    // estandar de su cliente
+    std::string directorio;         // base de las rutas relativas; "" = el del proceso
+    FILE* entrada = stdin;
+    bool enServidor = false;
+};
+
+// Salida de un archivo, acumulada para imprimirla en el orden de la linea
+// de comandos aunque los archivos se analicen en paralelo
+struct Resultado {
+    int codigo = 0;
+    std::string salida;     // va a stdout
+    std::string errores;    // va a stderr
+    std::string diagnosticos;   // registros jsonl o sarif, van a stdout
+};
 
 bool validarExtension(const char* nombreArchivo) {
     const char* extension = strrchr(nombreArchivo, '.');
@@ -16,36 +67,669 @@ bool validarExtension(const char* nombreArchivo) {
     return strcmp(extension, ".m0") == 0;
 }
 
-int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Uso: ./parser <archivo.m0>" << std::endl;
+// Donde abrir una ruta de la linea de comandos
+std::string enDirectorio(const Opciones& opciones, const std::string& ruta) {
+    if (opciones.directorio.empty() || ruta.empty() || ruta[0] == '/') {
+        return ruta;
+    }
+    return opciones.directorio + "/" + ruta;
+}
+
+// Agrega los .m0 de un directorio (recursivo), ordenados por ruta
+bool agregarDirectorio(const std::string& ruta, const Opciones& opciones,
+                       std::vector<std::string>& archivos, std::ostream& errores) {
+    std::error_code ec;
+    std::vector<std::string> encontrados;
+    // Se recorre la ruta ya resuelta pero se listan como debajo de ruta
+    std::string base = enDirectorio(opciones, ruta);
+    std::filesystem::recursive_directory_iterator it(base, ec), fin;
+    for (; !ec && it != fin; it.increment(ec)) {
+        if (it->is_regular_file(ec) && validarExtension(it->path().c_str())) {
+            encontrados.push_back(ruta + it->path().string().substr(base.size()));
+        }
+    }
+    if (ec) {
+        errores << "Error: No se pudo recorrer el directorio '" << ruta << "'" << std::endl;
+        return false;
+    }
+    std::sort(encontrados.begin(), encontrados.end());
+    archivos.insert(archivos.end(), encontrados.begin(), encontrados.end());
+    return true;
+}
+
+// Archivo de respuesta (@lista): una ruta (archivo o directorio) por linea
+bool agregarRespuesta(const std::string& ruta, const Opciones& opciones,
+                      std::vector<std::string>& entradas, std::ostream& errores) {
+    std::ifstream lista(enDirectorio(opciones, ruta));
+    if (!lista) {
+        errores << "Error: No se pudo abrir el archivo de respuesta '" << ruta << "'" << std::endl;
+        return false;
+    }
+    std::string linea;
+    while (std::getline(lista, linea)) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (!linea.empty()) entradas.push_back(linea);
+    }
+    return true;
+}
+
+// El numero de una opcion (texto, sin el nombre): tiene que ser todo el
+// texto y estar entre minimo y maximo. Si no, explica el error
+bool leerNumero(const char* texto, const char* opcion, long long minimo, long long maximo,
+                long long& valor, std::ostream& errores) {
+    char* fin;
+    errno = 0;
+    valor = strtoll(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || errno == ERANGE || valor < minimo || valor > maximo) {
+        errores << "Error: " << opcion << " debe ser un numero entre " << minimo << " y "
+                << maximo << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// --ediciones=lista: una edicion por linea, "inicio fin texto", que
+// reemplaza los bytes [inicio, fin) por el texto (quizas vacio), con \n,
+// \t y \\ como escapes. Se aplican en orden, cada una sobre el resultado
+// de la anterior.
+bool leerEdiciones(const std::string& ruta, const Opciones& opciones,
+                   std::vector<Edicion>& ediciones, std::ostream& errores) {
+    std::ifstream lista(enDirectorio(opciones, ruta));
+    if (!lista) {
+        errores << "Error: No se pudo abrir la lista de ediciones '" << ruta << "'" << std::endl;
+        return false;
+    }
+    std::string linea;
+    for (int numero = 1; std::getline(lista, linea); numero++) {
+        std::istringstream campos(linea);
+        Edicion edicion;
+        if (!(campos >> edicion.inicio >> edicion.fin)) {
+            errores << "Error: Edicion invalida en la linea " << numero << " de '"
+                    << ruta << "'" << std::endl;
+            return false;
+        }
+        std::string texto;
+        std::getline(campos, texto);
+        for (size_t i = texto.empty() ? 0 : 1; i < texto.size(); i++) {
+            if (texto[i] == '\\' && i + 1 < texto.size()) {
+                char c = texto[++i];
+                edicion.texto += c == 'n' ? '\n' : c == 't' ? '\t' : c;
+            } else {
+                edicion.texto += texto[i];
+            }
+        }
+        ediciones.push_back(edicion);
+    }
+    return true;
+}
+
+// Errores o mensaje de exito (y el arbol con --ast) de un analisis. Con
+// --diagnosticos=jsonl|sarif solo los registros de los errores.
+void informarResultado(const ParserContext& ctx, const std::string& archivo,
+                       const Opciones& opciones, std::ostringstream& err, Resultado& resultado) {
+    if (opciones.diagnosticos != DIAGNOSTICOS_TEXTO) {
+        if (opciones.diagnosticos == DIAGNOSTICOS_JSONL) {
+            escribirJsonl(ctx, archivo, resultado.diagnosticos);
+        } else {
+            escribirResultadosSarif(ctx, archivo, resultado.diagnosticos);
+        }
+        resultado.codigo = tieneErrores(ctx) ? 1 : 0;
+    } else if (tieneErrores(ctx)) {
+        mostrarErrores(ctx, err);
+        resultado.codigo = 1;
+    } else {
+        resultado.salida = opciones.analisis.semantico ? "Analisis semantico exitoso\n"
+                                                       : "Analisis sintactico exitoso\n";
+        if (opciones.mostrarAst) {
+            std::ostringstream arbol;
+            imprimirAst(ctx.ast, ctx.interner, arbol);
+            resultado.salida += arbol.str();
+        }
+    }
+    resultado.errores = err.str();
+}
+
+// --ejecutar: corre main con el interprete si el analisis no encontro
+// errores. Su resultado sigue al mensaje de exito; un error de ejecucion
+// va a los errores. Llamar antes de liberar la fuente.
+void ejecutarMain(ParserContext& ctx, const Semantica& semantica, const Opciones& opciones,
+                  Resultado& resultado) {
+    if (!opciones.ejecutar || tieneErrores(ctx)) {
+        return;
+    }
+    Ejecucion ejecucion;
+    ejecucion.maximoPasos = opciones.maximoPasos;
+    auto inicio = std::chrono::steady_clock::now();
+    bool correcta = ejecutarPrograma(ctx, semantica, ejecucion);
+    auto fin = std::chrono::steady_clock::now();
+    if (opciones.estadisticas) {
+        double ms = std::chrono::duration<double, std::milli>(fin - inicio).count();
+        std::ostringstream err;
+        err << "Ejecucion: " << ejecucion.pasos << " pasos, " << ejecucion.llamadas
+            << " llamadas (profundidad maxima " << ejecucion.profundidadMaxima << "), "
+            << ejecucion.elementos << " elementos de arreglos en " << ms << " ms ("
+            << (ms > 0 ? ejecucion.pasos / (ms / 1000.0) : 0.0) << " pasos/s)" << std::endl;
+        resultado.errores += err.str();
+    }
+    if (correcta) {
+        resultado.salida += "Resultado de main: " + ejecucion.resultado + "\n";
+    } else {
+        escribirErrorEjecucion(ctx, ejecucion, resultado.errores);
+        resultado.codigo = 1;
+    }
+}
+
+// Nombre de la entrada estandar en la linea de comandos ('-' o --stdin)
+static const char* const ENTRADA_ESTANDAR = "-";
+
+// Carga el archivo en fuente; si falla deja el mensaje en resultado
+bool cargarArchivo(const std::string& archivo, const Opciones& opciones,
+                   Fuente& fuente, Resultado& resultado) {
+    if (archivo == ENTRADA_ESTANDAR) {
+        if (!leerFuente(opciones.entrada, fuente)) {
+            resultado.errores = "Error: No se pudo leer la entrada estandar\n";
+            resultado.codigo = 1;
+            return false;
+        }
+        return true;
+    }
+    // Por defecto el archivo se proyecta con mmap; los pipes y FIFOs (o
+    // --sin-mmap) se leen completos al heap. En ambos casos el lexer recorre
+    // el texto en su lugar y los tokens guardan offsets sobre el.
+    std::string ruta = enDirectorio(opciones, archivo);
+    if (opciones.usarMmap && mapearFuente(ruta.c_str(), fuente)) {
+        return true;
+    }
+    FILE* entrada = fopen(ruta.c_str(), "r");
+    if (!entrada) {
+        resultado.errores = "Error: No se pudo abrir el archivo '" + archivo + "'\n";
+        resultado.codigo = 1;
+        return false;
+    }
+    bool leido = leerFuente(entrada, fuente);
+    fclose(entrada);
+    if (!leido) {
+        resultado.errores = "Error: No se pudo leer el archivo '" + archivo + "'\n";
+        resultado.codigo = 1;
+        return false;
+    }
+    return true;
+}
+
+std::string describirToken(const TokenBuffer& tokens, size_t i) {
+    std::ostringstream os;
+    os << "tipo " << (int)tokens.tipos[i] << ", offset " << tokens.offsets[i]
+       << ", longitud " << tokens.longitudes[i] << ", valor " << tokens.valores[i];
+    return os.str();
+}
+
+// --comparar-lexers: el flujo del lexer SIMD debe ser identico al de flex,
+// que es la referencia. Reporta el primer token distinto.
+Resultado compararLexers(const std::string& archivo, const Opciones& opciones) {
+    Resultado resultado;
+    Fuente fuente;
+    if (!cargarArchivo(archivo, opciones, fuente, resultado)) {
+        return resultado;
+    }
+
+    Interner internerFlex, internerSimd;
+    TokenBuffer flex, simd;
+    tokenizar(flex, internerFlex, fuente.datos, fuente.longitud);
+    tokenizarSimd(simd, internerSimd, fuente.datos, fuente.longitud);
+
+    size_t n = std::min(flex.cantidad(), simd.cantidad());
+    size_t i = 0;
+    while (i < n && flex.tipos[i] == simd.tipos[i] && flex.offsets[i] == simd.offsets[i] &&
+           flex.longitudes[i] == simd.longitudes[i] && flex.valores[i] == simd.valores[i]) {
+        i++;
+    }
+    liberarFuente(fuente);
+
+    if (i == n && flex.cantidad() == simd.cantidad()) {
+        resultado.salida = "Lexers coinciden: " + std::to_string(n) + " tokens\n";
+    } else {
+        std::ostringstream err;
+        err << "Los lexers difieren en el token " << i << "\n";
+        err << "  flex: " << (i < flex.cantidad() ? describirToken(flex, i) : "(fin)") << "\n";
+        err << "  simd: " << (i < simd.cantidad() ? describirToken(simd, i) : "(fin)") << "\n";
+        resultado.errores = err.str();
+        resultado.codigo = 1;
+    }
+    return resultado;
+}
+
+// Si no se pudo reservar la pila para --max-profundidad, el parser corrio
+// con un limite menor (ver conPilaSuficiente): se avisa para que el error
+// de anidamiento no parezca ignorar la opcion
+void avisarProfundidad(bool completa, const ParserContext& ctx, const Opciones& opciones,
+                       std::ostream& err) {
+    if (!completa) {
+        err << "Aviso: No se pudo reservar la pila para --max-profundidad="
+            << opciones.analisis.profundidadMaxima << "; se usa " << ctx.profundidadMaxima
+            << std::endl;
+    }
+}
+
+// Analiza la entrada estandar sin cargarla completa: el parser pide tokens
+// al lexer a medida que los consume y solo se retiene la entrada desde el
+// lookahead
+Resultado analizarFlujo(const Opciones& opciones) {
+    Resultado resultado;
+    std::ostringstream err;
+    auto inicio = std::chrono::steady_clock::now();
+
+    FlujoEntrada flujo;
+    flujo.archivo = opciones.entrada;
+    flujo.lexerSimd = opciones.analisis.lexerSimd;
+
+    ParserContext ctx;
+    ctx.flujo = &flujo;
+    // Sin --ast cada declaracion se libera al terminarla
+    ctx.retenerAst = opciones.mostrarAst;
+    bool completa = analizarContexto(ctx, opciones.analisis);
+    avisarProfundidad(completa, ctx, opciones, err);
+
+    if (ferror(opciones.entrada)) {
+        resultado.errores = "Error: No se pudo leer la entrada estandar\n";
+        resultado.codigo = 1;
+        return resultado;
+    }
+
+    if (opciones.estadisticas) {
+        auto fin = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(fin - inicio).count();
+        err << "Entrada: flujo, " << flujo.bytesLeidos << " bytes en " << ms << " ms ("
+            << (ms > 0 ? flujo.bytesLeidos / (ms * 1000.0) : 0.0) << " MB/s)" << std::endl;
+        err << "Lexer y parser: " << flujo.tokensTotales << " tokens; buffer maximo "
+            << flujo.datos.capacity() << " bytes" << std::endl;
+        err << "Simbolos internados: " << ctx.interner.cantidad()
+            << " (" << ctx.interner.bytesArena() << " bytes)" << std::endl;
+    }
+
+    informarResultado(ctx, ENTRADA_ESTANDAR, opciones, err, resultado);
+    return resultado;
+}
+
+Resultado analizarArchivo(const std::string& archivo, const Opciones& opciones) {
+    // Las pasadas semanticas recorren el arbol completo con todos sus
+    // tokens: con --semantico la entrada estandar se carga entera
+    if (archivo == ENTRADA_ESTANDAR && !opciones.analisis.semantico) {
+        return analizarFlujo(opciones);
+    }
+    Resultado resultado;
+    std::ostringstream err;
+    auto inicio = std::chrono::steady_clock::now();
+
+    Fuente fuente;
+    if (!cargarArchivo(archivo, opciones, fuente, resultado)) {
+        return resultado;
+    }
+
+    ParserContext ctx;
+    if (opciones.analisis.lexerSimd) {
+        tokenizarSimd(ctx.tokens, ctx.interner, fuente.datos, fuente.longitud);
+    } else {
+        tokenizar(ctx.tokens, ctx.interner, fuente.datos, fuente.longitud);
+    }
+    auto finLexer = std::chrono::steady_clock::now();
+
+    EstadisticasParalelo paralelo;
+    bool completa = analizarContexto(ctx, opciones.analisis, &paralelo);
+    avisarProfundidad(completa, ctx, opciones, err);
+    auto finParser = std::chrono::steady_clock::now();
+    Semantica semantica;
+    analizarSemantica(ctx, semantica, opciones.analisis);
+
+    if (opciones.estadisticas) {
+        auto fin = std::chrono::steady_clock::now();
+        double msLexer = std::chrono::duration<double, std::milli>(finLexer - inicio).count();
+        double msParser = std::chrono::duration<double, std::milli>(finParser - finLexer).count();
+        double ms = msLexer + msParser;
+        err << "Entrada: " << (fuente.reservado > 0 ? "mmap" : "heap")
+            << ", " << fuente.longitud << " bytes en " << ms << " ms ("
+            << (ms > 0 ? fuente.longitud / (ms * 1000.0) : 0.0) << " MB/s)" << std::endl;
+        err << "Lexer: " << ctx.tokens.cantidad() << " tokens en " << msLexer
+            << " ms; parser: " << msParser << " ms" << std::endl;
+        err << "Simbolos internados: " << ctx.interner.cantidad()
+            << " (" << ctx.interner.bytesArena() << " bytes)" << std::endl;
+        size_t nodos = ctx.ast.cantidad();
+        err << "AST: " << nodos << " nodos, " << ctx.ast.bytes() << " bytes ("
+            << (nodos > 0 ? (double)ctx.ast.bytes() / nodos : 0.0) << " bytes/nodo, "
+            << (msParser > 0 ? nodos / (msParser / 1000.0) : 0.0) << " nodos/s)" << std::endl;
+        if (paralelo.tramos > 0) {
+            err << "Parser paralelo: " << paralelo.tramos << " tramos en "
+                << opciones.analisis.hilosParser << " hilos, " << paralelo.realineados
+                << " realineados (" << paralelo.declaracionesSecuenciales
+                << " declaraciones en secuencia)" << std::endl;
+        }
+        if (opciones.analisis.semantico && semantica.busquedas + semantica.declaraciones > 0) {
+            double msSemantica = std::chrono::duration<double, std::milli>(fin - finParser).count();
+            double segundos = msSemantica / 1000.0;
+            err << "Semantico: " << semantica.declaraciones << " declaraciones, "
+                << semantica.busquedas << " busquedas, " << semantica.expresiones
+                << " expresiones en " << msSemantica << " ms ("
+                << (segundos > 0 ? semantica.busquedas / segundos : 0.0) << " busquedas/s, "
+                << (segundos > 0 ? semantica.expresiones / segundos : 0.0) << " expresiones/s)"
+                << std::endl;
+            if (semantica.tareas > 0) {
+                err << "Semantico paralelo: " << semantica.firmas.size() << " funciones en "
+                    << semantica.tareas << " tareas, "
+                    << std::min<size_t>(opciones.analisis.hilosSemantico, semantica.tareas)
+                    << " hilos" << std::endl;
+            }
+            if (opciones.analisis.plegar) {
+                err << "Plegado: " << semantica.plegadas << " operaciones, "
+                    << semantica.nodosEliminados << " nodos eliminados" << std::endl;
+            }
+        }
+    }
+
+    // Los mensajes de error citan la fuente: se arman antes de liberarla
+    informarResultado(ctx, archivo, opciones, err, resultado);
+    ejecutarMain(ctx, semantica, opciones, resultado);
+    liberarFuente(fuente);
+    return resultado;
+}
+
+// --ediciones: abre el archivo como documento y le aplica las ediciones
+// una por una, reanalizando solo las declaraciones afectadas
+Resultado analizarConEdiciones(const std::string& archivo, const Opciones& opciones) {
+    Resultado resultado;
+    std::ostringstream err;
+    Fuente fuente;
+    if (!cargarArchivo(archivo, opciones, fuente, resultado)) {
+        return resultado;
+    }
+
+    Documento doc;
+    bool valido = true;
+    bool completa = conPilaSuficiente(doc.ctx, opciones.analisis, [&]() {
+        auto inicio = std::chrono::steady_clock::now();
+        abrirDocumento(doc, fuente.datos, fuente.longitud);
+        auto fin = std::chrono::steady_clock::now();
+        if (opciones.estadisticas) {
+            err << "Analisis completo: " << doc.ultimo.tokensLexados << " tokens, "
+                << doc.decls.size() << " declaraciones en "
+                << std::chrono::duration<double, std::milli>(fin - inicio).count() << " ms"
+                << std::endl;
+        }
+        double msTotal = 0;
+        for (size_t i = 0; i < opciones.ediciones.size() && valido; i++) {
+            inicio = std::chrono::steady_clock::now();
+            valido = editarDocumento(doc, opciones.ediciones[i]);
+            fin = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(fin - inicio).count();
+            msTotal += ms;
+            if (!valido) {
+                err << "Error: La edicion " << (i + 1) << " esta fuera de la fuente ("
+                    << doc.longitud() << " bytes)" << std::endl;
+            } else if (opciones.estadisticas) {
+                const Reanalisis& r = doc.ultimo;
+                err << "Edicion " << (i + 1) << ": " << r.tokensLexados << " tokens lexados, "
+                    << r.declaracionesAnalizadas << " declaraciones analizadas, "
+                    << r.declaracionesReusadas << " reusadas" << (r.completo ? " (completo)" : "")
+                    << " en " << ms << " ms" << std::endl;
+            }
+        }
+        if (opciones.estadisticas && !opciones.ediciones.empty()) {
+            err << "Ediciones: " << opciones.ediciones.size() << " en " << msTotal << " ms ("
+                << msTotal / opciones.ediciones.size() << " ms por edicion)" << std::endl;
+        }
+    });
+    avisarProfundidad(completa, doc.ctx, opciones, err);
+    liberarFuente(fuente);
+
+    if (!valido) {
+        resultado.errores = err.str();
+        resultado.codigo = 1;
+        return resultado;
+    }
+    Semantica semantica;
+    analizarSemantica(doc.ctx, semantica, opciones.analisis);
+    informarResultado(doc.ctx, archivo, opciones, err, resultado);
+    ejecutarMain(doc.ctx, semantica, opciones, resultado);
+    return resultado;
+}
+
+int servirPedidos(const std::string& ruta, const Opciones& opciones, std::ostream& errores);
+
+// Una invocacion del programa: argumentos sin el nombre del programa, y
+// salida y errores en lugar de stdout y stderr. Devuelve el codigo de salida.
+int ejecutarLinea(const std::vector<std::string>& argumentos, Opciones opciones,
+                  std::ostream& salida, std::ostream& errores) {
+    std::vector<std::string> entradas;
+    std::string servidor;
+
+    for (size_t i = 0; i < argumentos.size(); i++) {
+        const char* argumento = argumentos[i].c_str();
+        if (strcmp(argumento, "--sin-mmap") == 0) {
+            opciones.usarMmap = false;
+        } else if (strcmp(argumento, "--estadisticas") == 0) {
+            opciones.estadisticas = true;
+        } else if (strcmp(argumento, "--lexer=flex") == 0) {
+            opciones.analisis.lexerSimd = false;
+        } else if (strcmp(argumento, "--lexer=simd") == 0) {
+            opciones.analisis.lexerSimd = true;
+        } else if (strcmp(argumento, "--parser=descendente") == 0) {
+            opciones.analisis.parserTabla = false;
+        } else if (strcmp(argumento, "--parser=ll1") == 0) {
+            opciones.analisis.parserTabla = true;
+        } else if (strcmp(argumento, "--gramatica") == 0) {
+            imprimirGramatica(salida);
+            return 0;
+        } else if (strcmp(argumento, "--semantico") == 0) {
+            opciones.analisis.semantico = true;
+        } else if (strcmp(argumento, "--plegar") == 0) {
+            opciones.analisis.semantico = true;
+            opciones.analisis.plegar = true;
+        } else if (strcmp(argumento, "--ejecutar") == 0 || strcmp(argumento, "--run") == 0) {
+            opciones.analisis.semantico = true;
+            opciones.ejecutar = true;
+        } else if (strncmp(argumento, "--max-pasos=", 12) == 0) {
+            long long maximo;
+            if (!leerNumero(argumento + 12, "--max-pasos", 1, LLONG_MAX, maximo, errores)) {
+                return 1;
+            }
+            opciones.maximoPasos = (uint64_t)maximo;
+        } else if (strcmp(argumento, "--ast") == 0) {
+            opciones.mostrarAst = true;
+        } else if (strcmp(argumento, "--paralelo") == 0) {
+            opciones.paralelo = true;
+        } else if (strncmp(argumento, "--ediciones=", 12) == 0) {
+            opciones.conEdiciones = true;
+            if (!leerEdiciones(argumento + 12, opciones, opciones.ediciones, errores)) return 1;
+        } else if (strncmp(argumento, "--diagnosticos=", 15) == 0) {
+            const char* formato = argumento + 15;
+            if (strcmp(formato, "texto") == 0) {
+                opciones.diagnosticos = DIAGNOSTICOS_TEXTO;
+            } else if (strcmp(formato, "jsonl") == 0) {
+                opciones.diagnosticos = DIAGNOSTICOS_JSONL;
+            } else if (strcmp(formato, "sarif") == 0) {
+                opciones.diagnosticos = DIAGNOSTICOS_SARIF;
+            } else {
+                errores << "Error: --diagnosticos debe ser texto, jsonl o sarif" << std::endl;
+                return 1;
+            }
+        } else if (strcmp(argumento, "--comparar-lexers") == 0) {
+            opciones.compararLexers = true;
+        } else if (strncmp(argumento, "--max-profundidad=", 18) == 0) {
+            long long maximo;
+            if (!leerNumero(argumento + 18, "--max-profundidad", 1, INT_MAX, maximo, errores)) {
+                return 1;
+            }
+            opciones.analisis.profundidadMaxima = (int)maximo;
+        } else if (strncmp(argumento, "--max-errores=", 14) == 0) {
+            long long maximo;
+            if (!leerNumero(argumento + 14, "--max-errores", 1, LLONG_MAX, maximo, errores)) {
+                return 1;
+            }
+            opciones.analisis.maximoErrores = (size_t)maximo;
+        } else if (strncmp(argumento, "--hilos=", 8) == 0 || strncmp(argumento, "-j", 2) == 0) {
+            // --hilos=N, -j N o -jN
+            const char* numero = argumento[1] == 'j' ? argumento + 2 : argumento + 8;
+            if (strcmp(argumento, "-j") == 0) {
+                numero = i + 1 < argumentos.size() ? argumentos[++i].c_str() : "";
+            }
+            long long hilos;
+            if (!leerNumero(numero, "-j/--hilos", 1, MAXIMO_HILOS, hilos, errores)) {
+                return 1;
+            }
+            opciones.hilos = (unsigned)hilos;
+        } else if (strncmp(argumento, "--servidor=", 11) == 0 && !opciones.enServidor) {
+            servidor = argumento + 11;
+        } else if (strcmp(argumento, "--stdin") == 0) {
+            entradas.push_back(ENTRADA_ESTANDAR);
+        } else if (argumento[0] == '@') {
+            if (!agregarRespuesta(argumento + 1, opciones, entradas, errores)) return 1;
+        } else {
+            entradas.push_back(argumentos[i]);
+        }
+    }
+
+    if (!servidor.empty()) {
+        return servirPedidos(servidor, opciones, errores);
+    }
+
+    if (entradas.empty()) {
+        errores << "Uso: ./parser [--sin-mmap] [--estadisticas] [--lexer=flex|simd] "
+                << "[--parser=descendente|ll1] [--comparar-lexers] [--ast] "
+                << "[--max-profundidad=N] [--max-errores=N] [-j N | --hilos=N] [--gramatica] "
+                << "[--paralelo] [--ediciones=lista] [--diagnosticos=texto|jsonl|sarif] "
+                << "[--semantico] [--plegar] [--ejecutar | --run] [--max-pasos=N] "
+                << "[--servidor=socket] "
+                << "<archivo.m0 | directorio | @lista | - | --stdin>..." << std::endl;
         return 1;
     }
 
-    if (!validarExtension(argv[1])) {
-        std::cerr << "Error: El archivo debe tener extension .m0" << std::endl;
-        std::cerr << "Archivo proporcionado: " << argv[1] << std::endl;
+    if (opciones.diagnosticos != DIAGNOSTICOS_TEXTO &&
+        (opciones.mostrarAst || opciones.compararLexers || opciones.ejecutar)) {
+        errores << "Error: --diagnosticos=jsonl|sarif usa stdout; no va con --ast, "
+                << "--comparar-lexers ni --ejecutar" << std::endl;
         return 1;
     }
 
-    yyin = fopen(argv[1], "r");
-    if (!yyin) {
-        std::cerr << "Error: No se pudo abrir el archivo '" << argv[1] << "'" << std::endl;
+    if (opciones.conEdiciones && opciones.analisis.parserTabla) {
+        errores << "Error: --ediciones reanaliza con el parser descendente" << std::endl;
         return 1;
     }
 
-    extern int lookahead;
-    lookahead = yylex();
+    // Los directorios se expanden a sus .m0; los archivos dados
+    // explicitamente deben tener extension .m0
+    std::vector<std::string> archivos;
+    bool usaEntradaEstandar = false;
+    for (const std::string& entrada : entradas) {
+        std::error_code ec;
+        if (entrada == ENTRADA_ESTANDAR) {
+            if (usaEntradaEstandar || opciones.compararLexers || opciones.conEdiciones) {
+                errores << "Error: La entrada estandar solo se puede analizar una vez "
+                        << "y no con --comparar-lexers ni --ediciones" << std::endl;
+                return 1;
+            }
+            usaEntradaEstandar = true;
+            archivos.push_back(entrada);
+        } else if (std::filesystem::is_directory(enDirectorio(opciones, entrada), ec)) {
+            if (!agregarDirectorio(entrada, opciones, archivos, errores)) return 1;
+        } else if (!validarExtension(entrada.c_str())) {
+            errores << "Error: El archivo debe tener extension .m0" << std::endl;
+            errores << "Archivo proporcionado: " << entrada << std::endl;
+            return 1;
+        } else {
+            archivos.push_back(entrada);
+        }
+    }
 
-    programa();
+    unsigned hilos = opciones.hilos > 0 ? opciones.hilos : hilosPorDefecto();
+    bool variosArchivos = archivos.size() != 1;
+    // Con varios archivos los hilos ya se reparten entre ellos
+    if (opciones.paralelo && !variosArchivos) {
+        opciones.analisis.hilosParser = hilos;
+        opciones.analisis.hilosSemantico = hilos;
+    }
 
-    if (tieneErrores()) {
-        mostrarErrores();
-        fclose(yyin);
-        return 1;
-    } else {
-        std::cout << "Analisis sintactico exitoso" << std::endl;
-        fclose(yyin);
-        return 0;
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<Resultado> resultados(archivos.size());
+    ejecutarEnParalelo(archivos.size(), hilos, [&](size_t i) {
+        if (opciones.compararLexers) {
+            resultados[i] = compararLexers(archivos[i], opciones);
+        } else if (opciones.conEdiciones) {
+            resultados[i] = analizarConEdiciones(archivos[i], opciones);
+        } else {
+            resultados[i] = analizarArchivo(archivos[i], opciones);
+        }
+    });
+    auto fin = std::chrono::steady_clock::now();
+
+    // Salida en el orden de entrada; con varios archivos cada bloque lleva
+    // la ruta para saber de donde viene. Los diagnosticos jsonl o sarif de
+    // todos los archivos van juntos a stdout (un solo documento SARIF).
+    int codigo = 0;
+    size_t conErrores = 0;
+    bool registros = opciones.diagnosticos != DIAGNOSTICOS_TEXTO;
+    SalidaDiagnosticos diagnosticos;
+    if (registros) {
+        abrirSalida(diagnosticos, salida, opciones.diagnosticos);
+    }
+    for (size_t i = 0; i < archivos.size(); i++) {
+        const Resultado& r = resultados[i];
+        if (registros) {
+            agregarDiagnosticos(diagnosticos, r.diagnosticos);
+            if (!r.errores.empty()) {
+                errores << (variosArchivos ? archivos[i] + ":\n" : "") << r.errores;
+            }
+        } else if (variosArchivos) {
+            if (!r.salida.empty()) salida << archivos[i] << ": " << r.salida;
+            if (!r.errores.empty()) errores << archivos[i] << ":\n" << r.errores;
+        } else {
+            salida << r.salida;
+            errores << r.errores;
+        }
+        if (r.codigo != 0) {
+            codigo = r.codigo;
+            conErrores++;
+        }
     }
-}
\ No newline at end of file
+    if (registros) {
+        terminarSalida(diagnosticos);
+    }
+    salida.flush();
+
+    if (variosArchivos || opciones.estadisticas) {
+        double ms = std::chrono::duration<double, std::milli>(fin - inicio).count();
+        errores << "Archivos: " << archivos.size() << " (" << conErrores
+                << " con errores) en " << ms << " ms con "
+                << std::min<size_t>(hilos, std::max<size_t>(archivos.size(), 1)) << " hilos ("
+                << (ms > 0 ? archivos.size() / (ms / 1000.0) : 0.0) << " archivos/s)" << std::endl;
+    }
+    if (opciones.estadisticas) {
+        errores << "Memoria maxima: " << memoriaMaximaKB() << " KB" << std::endl;
+    }
+
+    return codigo;
+}
+
+// --servidor: cada pedido es una invocacion completa, con los argumentos,
+// el directorio y la entrada estandar del cliente
+int servirPedidos(const std::string& ruta, const Opciones& opciones, std::ostream& errores) {
+    unsigned hilos = opciones.hilos > 0 ? opciones.hilos : hilosPorDefecto();
+    return ejecutarServidor(ruta, hilos, [](const Pedido& pedido, Respuesta& respuesta) {
+        Opciones deCliente;
+        deCliente.enServidor = true;
+        deCliente.directorio = pedido.directorio;
+        deCliente.entrada = fmemopen((void*)pedido.entrada.data(), pedido.entrada.size(), "r");
+        if (deCliente.entrada == nullptr) {
+            respuesta.codigo = 1;
+            respuesta.errores = "Error: No se pudo leer la entrada estandar\n";
+            return;
+        }
+        std::ostringstream salida, errores;
+        respuesta.codigo = ejecutarLinea(pedido.argumentos, deCliente, salida, errores);
+        fclose(deCliente.entrada);
+        respuesta.salida = salida.str();
+        respuesta.errores = errores.str();
+    }, errores);
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> argumentos(argv + 1, argv + argc);
+    return ejecutarLinea(argumentos, Opciones(), std::cout, std::cerr);
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "paralelo.h"
+#include "pool.h"
+#include "tokens.h"
+
+using namespace std;
+
+// Varios tramos por hilo, para que el robo de trabajo empareje tramos de
+// distinto costo
+static const size_t TRAMOS_POR_HILO = 4;
+// Con menos tokens no se amortiza copiar los tokens y el arbol de un tramo
+static const size_t MINIMO_TOKENS_TRAMO = 64 * 1024;
+
+// Parte del archivo que analiza un hilo, con su propio contexto. Sus
+// tokens son una copia de los del tramo con los offsets relativos a
+// inicioBytes, asi las lineas de sus errores se cuentan desde ahi.
+struct Tramo {
+    size_t primerToken;         // en el ctx del archivo
+    size_t finToken;            // primer token del tramo siguiente (T_EOF en el ultimo)
+    uint32_t inicioBytes;
+    uint32_t lineas = 0;        // '\n' desde inicioBytes hasta el tramo siguiente
+    ParserContext ctx;
+    vector<DeclAnalizada> decls;    // primerToken relativo al tramo
+    size_t validas = 0;         // decls con el mismo resultado que en secuencia
+    bool alineado = false;      // la ultima termino justo en finToken
+};
+
+// ============================================================
+// Division en tramos
+// ============================================================
+
+// Tokens 'fun' en la columna 0 despues de desde, buscando el tipo con
+// memchr: es una pasada sobre un byte por token
+static vector<size_t> buscarCortes(const TokenBuffer& t, size_t desde) {
+    vector<size_t> cortes;
+    const uint8_t* tipos = t.tipos.data();
+    const uint8_t* p = tipos + desde + 1;
+    const uint8_t* fin = tipos + t.cantidad();
+    while (p < fin) {
+        p = (const uint8_t*)memchr(p, T_FUN, fin - p);
+        if (p == nullptr) {
+            break;
+        }
+        size_t i = p - tipos;
+        if (t.fuente[t.offsets[i] - 1] == '\n') {
+            cortes.push_back(i);
+        }
+        p++;
+    }
+    return cortes;
+}
+
+// Primer token de cada tramo: el primero es inicio y los demas el primer
+// corte despues de cada fraccion pareja de los tokens
+static vector<size_t> elegirInicios(const TokenBuffer& t, size_t inicio, size_t cantidad) {
+    vector<size_t> cortes = buscarCortes(t, inicio);
+    vector<size_t> inicios{inicio};
+    size_t total = t.cantidad() - inicio;
+    for (size_t k = 1; k < cantidad; k++) {
+        size_t objetivo = inicio + total * k / cantidad;
+        auto it = lower_bound(cortes.begin(), cortes.end(), max(objetivo, inicios.back() + 1));
+        if (it == cortes.end()) {
+            break;
+        }
+        inicios.push_back(*it);
+    }
+    return inicios;
+}
+
+// ============================================================
+// Analisis de un tramo
+// ============================================================
+
+static void analizarTramo(const ParserContext& archivo, Tramo& tramo, bool ultimo,
+                          uint32_t finBytes) {
+    const TokenBuffer& t = archivo.tokens;
+    TokenBuffer& propios = tramo.ctx.tokens;
+    size_t desde = tramo.primerToken;
+    // Hasta el primer token del tramo siguiente inclusive: es el lookahead
+    // con el que termina la ultima declaracion. Despues va un T_EOF que
+    // solo ve una declaracion que lo pasa de largo.
+    size_t hasta = ultimo ? t.cantidad() : tramo.finToken + 1;
+    propios.tipos.assign(t.tipos.begin() + desde, t.tipos.begin() + hasta);
+    propios.longitudes.assign(t.longitudes.begin() + desde, t.longitudes.begin() + hasta);
+    propios.valores.assign(t.valores.begin() + desde, t.valores.begin() + hasta);
+    propios.offsets.resize(hasta - desde);
+    for (size_t i = desde; i < hasta; i++) {
+        propios.offsets[i - desde] = t.offsets[i] - tramo.inicioBytes;
+    }
+    uint32_t finVentana = (uint32_t)t.longitudFuente;
+    if (!ultimo) {
+        finVentana = t.offsets[tramo.finToken] + t.longitudes[tramo.finToken];
+        propios.agregar(T_EOF, finVentana - tramo.inicioBytes, 0, 0);
+    }
+    propios.fuente = t.fuente + tramo.inicioBytes;
+    propios.longitudFuente = finVentana - tramo.inicioBytes;
+
+    ParserContext& ctx = tramo.ctx;
+    ctx.profundidadMaxima = archivo.profundidadMaxima;
+    ctx.maximoErrores = archivo.maximoErrores;
+    iniciarParser(ctx);
+    size_t fin = tramo.finToken - desde;
+    analizarDeclaraciones(ctx, tramo.decls, [fin](size_t p) { return p >= fin; });
+
+    // La ultima no sirve si vio el T_EOF agregado, o si la corto
+    // maximoErrores contando solo los errores del tramo
+    bool agotado = ctx.maximoErrores > 0 && ctx.errores.size() >= ctx.maximoErrores;
+    tramo.validas = tramo.decls.size();
+    if ((!ultimo && ctx.posToken > fin) || agotado) {
+        tramo.validas--;
+    } else {
+        tramo.alineado = !ctx.detenido;
+    }
+
+    if (tramo.inicioBytes > 0) {
+        for (Nodo& n : ctx.ast.nodos) {
+            n.offset += tramo.inicioBytes;
+        }
+    }
+    const char* p = t.fuente + tramo.inicioBytes;
+    const char* limite = t.fuente + finBytes;
+    while (p < limite && (p = (const char*)memchr(p, '\n', limite - p)) != nullptr) {
+        tramo.lineas++;
+        p++;
+    }
+    propios = TokenBuffer();
+    ctx.lineas.limpiar();
+}
+
+// ============================================================
+// Union en orden
+// ============================================================
+
+// Nodo de una declaracion: del arbol de un tramo o (tramo -1) del de ctx
+struct DeclUnida {
+    long tramo;
+    NodoId nodo;
+};
+
+// Con maximoErrores, la declaracion del tramo donde el total llega al
+// limite deja de ser valida: se analiza en secuencia, que se detiene en el
+// error justo. Las de antes registran los mismos errores que en secuencia.
+static void recortarPorErrores(const ParserContext& ctx, Tramo& tramo, size_t k) {
+    if (ctx.maximoErrores == 0 || k >= tramo.validas) {
+        return;
+    }
+    size_t desde = tramo.decls[k].primerError;
+    for (size_t i = k; i < tramo.validas; i++) {
+        size_t hasta = i + 1 < tramo.decls.size() ? tramo.decls[i + 1].primerError
+                                                  : tramo.ctx.errores.size();
+        if (ctx.errores.size() + (hasta - desde) >= ctx.maximoErrores) {
+            tramo.validas = i;
+            tramo.alineado = false;
+            return;
+        }
+    }
+}
+
+// Agrega a ctx los errores y nodos de las declaraciones [k, validas) del tramo
+static void tomarDeclaraciones(ParserContext& ctx, Tramo& tramo, long indice, size_t k,
+                               uint32_t lineasPrevias, vector<DeclUnida>& unidas) {
+    size_t desde = tramo.decls[k].primerError;
+    size_t hasta = tramo.validas < tramo.decls.size() ? tramo.decls[tramo.validas].primerError
+                                                       : tramo.ctx.errores.size();
+    for (size_t i = desde; i < hasta; i++) {
+        ErrorInfo& e = tramo.ctx.errores[i];
+        e.linea += lineasPrevias;
+        e.token += (uint32_t)tramo.primerToken;
+        e.offset += tramo.inicioBytes;
+        ctx.errores.push_back(e);
+    }
+    for (size_t i = k; i < tramo.validas; i++) {
+        unidas.push_back(DeclUnida{indice, tramo.decls[i].nodo});
+    }
+}
+
+NodoId programaParalelo(ParserContext& ctx, unsigned hilos, EstadisticasParalelo* estadisticas) {
+    iniciarParser(ctx);
+    skipNL(ctx);
+    const TokenBuffer& t = ctx.tokens;
+    size_t inicio = ctx.posToken;
+    size_t cantidad = min<size_t>((size_t)hilos * TRAMOS_POR_HILO,
+                                  (t.cantidad() - inicio) / MINIMO_TOKENS_TRAMO);
+    vector<size_t> inicios;
+    if (hilos > 1 && cantidad > 1 && ctx.lookahead != T_EOF) {
+        inicios = elegirInicios(t, inicio, cantidad);
+    }
+    if (inicios.size() < 2) {
+        iniciarParser(ctx);
+        return programa(ctx);
+    }
+
+    vector<Tramo> tramos(inicios.size());
+    for (size_t c = 0; c < tramos.size(); c++) {
+        tramos[c].primerToken = inicios[c];
+        tramos[c].finToken = c + 1 < tramos.size() ? inicios[c + 1] : t.cantidad() - 1;
+        // El primero desde el byte 0, asi sus lineas y columnas ya son las del archivo
+        tramos[c].inicioBytes = c == 0 ? 0 : t.offsets[inicios[c]];
+    }
+    ejecutarEnParalelo(tramos.size(), hilos, [&](size_t c) {
+        bool ultimo = c + 1 == tramos.size();
+        uint32_t finBytes = ultimo ? (uint32_t)t.longitudFuente : tramos[c + 1].inicioBytes;
+        analizarTramo(ctx, tramos[c], ultimo, finBytes);
+    });
+
+    // Se recorren los tramos en orden. Uno que no termino alineado con el
+    // siguiente se continua en secuencia en ctx hasta llegar al comienzo de
+    // una declaracion valida de algun tramo posterior, y se sigue desde ahi.
+    vector<DeclUnida> unidas;
+    size_t realineados = 0, secuenciales = 0;
+    size_t c = 0, k = 0;
+    uint32_t lineasPrevias = 0;     // '\n' antes de tramos[c]
+    while (c < tramos.size()) {
+        Tramo& tramo = tramos[c];
+        recortarPorErrores(ctx, tramo, k);
+        tomarDeclaraciones(ctx, tramo, (long)c, k, lineasPrevias, unidas);
+        if (tramo.alineado) {
+            lineasPrevias += tramo.lineas;
+            c++;
+            k = 0;
+            continue;
+        }
+        if (tramo.validas == tramo.decls.size()) {
+            ctx.detenido = true;    // supero el anidamiento: no se sigue
+            break;
+        }
+
+        realineados++;
+        ctx.posToken = tramo.primerToken + tramo.decls[tramo.validas].primerToken;
+        ctx.lookahead = t.tipos[ctx.posToken];
+        ctx.profundidad = 0;
+        size_t siguiente = c + 1, kSiguiente = 0;
+        uint32_t lineasSiguiente = lineasPrevias + tramo.lineas;
+        auto parar = [&](size_t p) {
+            while (siguiente < tramos.size()) {
+                const Tramo& u = tramos[siguiente];
+                while (kSiguiente < u.validas && u.primerToken + u.decls[kSiguiente].primerToken < p) {
+                    kSiguiente++;
+                }
+                if (kSiguiente < u.validas) {
+                    return u.primerToken + u.decls[kSiguiente].primerToken == p;
+                }
+                lineasSiguiente += u.lineas;
+                siguiente++;
+                kSiguiente = 0;
+            }
+            return false;
+        };
+        vector<DeclAnalizada> decls;
+        bool reusa = analizarDeclaraciones(ctx, decls, parar);
+        secuenciales += decls.size();
+        for (const DeclAnalizada& d : decls) {
+            unidas.push_back(DeclUnida{-1, d.nodo});
+        }
+        if (!reusa) {
+            break;      // T_EOF, o se detuvo
+        }
+        c = siguiente;
+        k = kSiguiente;
+        lineasPrevias = lineasSiguiente;
+    }
+
+    // Las arenas de los tramos van al final de la de ctx, con los ids de
+    // nodos e hijos corridos; cada tramo copia la suya en paralelo
+    Ast& ast = ctx.ast;
+    vector<size_t> baseNodos(tramos.size()), baseHijos(tramos.size());
+    size_t nodos = ast.nodos.size(), hijos = ast.hijos.size();
+    for (size_t i = 0; i < tramos.size(); i++) {
+        baseNodos[i] = nodos;
+        baseHijos[i] = hijos;
+        nodos += tramos[i].ctx.ast.nodos.size();
+        hijos += tramos[i].ctx.ast.hijos.size();
+    }
+    ast.nodos.resize(nodos);
+    ast.hijos.resize(hijos);
+    ejecutarEnParalelo(tramos.size(), hilos, [&](size_t i) {
+        Ast& propio = tramos[i].ctx.ast;
+        Nodo* nodo = ast.nodos.data() + baseNodos[i];
+        for (const Nodo& n : propio.nodos) {
+            *nodo = n;
+            nodo->primerHijo += (uint32_t)baseHijos[i];
+            nodo++;
+        }
+        NodoId* hijo = ast.hijos.data() + baseHijos[i];
+        for (NodoId h : propio.hijos) {
+            *hijo++ = h == NODO_NULO ? NODO_NULO : h + (NodoId)baseNodos[i];
+        }
+        propio = Ast();
+    });
+
+    size_t desde = ast.pila.size();
+    for (const DeclUnida& d : unidas) {
+        if (d.nodo != NODO_NULO) {
+            ast.apilar(d.tramo < 0 ? d.nodo : d.nodo + (NodoId)baseNodos[d.tramo]);
+        }
+    }
+    ast.raiz = ast.crear(N_PROGRAMA, 0, 0, 0, desde);
+    ctx.hayErrores = !ctx.errores.empty();
+
+    if (estadisticas != nullptr) {
+        estadisticas->tramos = tramos.size();
+        estadisticas->realineados = realineados;
+        estadisticas->declaracionesSecuenciales = secuenciales;
+    }
+    return ast.raiz;
+}
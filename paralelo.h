@@ -0,0 +1,26 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include <cstddef>
+#include "parser.h"
+
+struct EstadisticasParalelo {
+    size_t tramos = 0;          // partes del archivo analizadas en paralelo
+    size_t realineados = 0;     // tramos que no empezaban en una declaracion
+    size_t declaracionesSecuenciales = 0;   // analizadas de nuevo al realinear
+};
+
+// Lo mismo que iniciarParser + programa() sobre ctx.tokens ya completos,
+// con el archivo partido en tramos que se analizan en paralelo. Cada tramo
+// empieza en un 'fun' de la columna 0, que en un archivo bien formado es
+// el comienzo de una declaracion; el tramo anterior se analiza hasta llegar
+// a ese token. Si una declaracion lo pasa de largo (un 'end' faltante) el
+// resultado especulativo del tramo siguiente no sirve desde ahi, y se
+// sigue en secuencia hasta volver a coincidir con el comienzo de una
+// declaracion ya analizada. El arbol y los errores (con sus lineas y
+// columnas) son los del analisis secuencial; solo cambian los ids de los
+// nodos. Archivos chicos o que no se pueden partir se analizan en
+// secuencia. Supone que pilaNecesaria(ctx) <= PILA_SEGURA.
+NodoId programaParalelo(ParserContext& ctx, unsigned hilos, EstadisticasParalelo* estadisticas);
+
+#endif
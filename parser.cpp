@@ -3,74 +3,114 @@
 #include <string>
 #include "tokens.h"
 #include "parser.h"
+#include "tokenbuffer.h"
+#include "flujo.h"
+#include "gramatica.h"
 
 using namespace std;
 
-// ============================================================
-// Variables globales
-// ============================================================
-int lookahead;
-extern int yylex();
-extern int yylineno;
-extern int tokenLinea;
-extern char* yytext;
-
-struct ErrorInfo {
-    int linea;
-    string mensaje;
-};
-
-vector<ErrorInfo> errores;
-bool hayErrores = false;
-
 // ============================================================
 // Declaraciones forward
 // ============================================================
-void match(int expected);
-void errorSintactico(const char* esperado);
-void sincronizar(const vector<int>& siguientes);
-
-void programa();
-void decl();
-void nl();
-void globalDecl();
-void funcion();
-void bloque();
-void params();
-void parametro();
-void tipo();
-void tipobase();
-void declvar();
-void comando();
-void cmdif();
-void cmdwhile();
-void cmdreturn();
-void listaexp();
-void exp();
-void expOr();
-void expOrPrime();
-void expAnd();
-void expAndPrime();
-void expRel();
-void expRelPrime();
-void expAdd();
-void expAddPrime();
-void expMul();
-void expMulPrime();
-void expUnary();
-void expFactor();
+int verToken(ParserContext& ctx, size_t k);
+void match(ParserContext& ctx, int expected);
+void agregarError(ParserContext& ctx, CodigoError codigo, const char* esperado);
+void sincronizar(ParserContext& ctx, const ConjuntoTokens& siguientes);
+
+NodoId programa(ParserContext& ctx);
+NodoId decl(ParserContext& ctx);
+void nl(ParserContext& ctx);
+NodoId globalDecl(ParserContext& ctx);
+NodoId funcion(ParserContext& ctx);
+NodoId bloque(ParserContext& ctx);
+void params(ParserContext& ctx);
+NodoId parametro(ParserContext& ctx);
+NodoId tipo(ParserContext& ctx);
+int tipobase(ParserContext& ctx);
+NodoId declvar(ParserContext& ctx);
+NodoId comando(ParserContext& ctx);
+NodoId cmdif(ParserContext& ctx);
+NodoId cmdwhile(ParserContext& ctx);
+NodoId cmdreturn(ParserContext& ctx);
+void listaexp(ParserContext& ctx);
+NodoId llamada(ParserContext& ctx, uint32_t offset, uint32_t nombre);
+NodoId variable(ParserContext& ctx, uint32_t offset, uint32_t nombre);
+NodoId exp(ParserContext& ctx);
+NodoId expBinaria(ParserContext& ctx, int minima);
+NodoId expUnary(ParserContext& ctx);
+NodoId expFactor(ParserContext& ctx);
+
+// Niveles de precedencia de los operadores binarios
+enum Precedencia {
+    PREC_OR = 1,
+    PREC_AND,
+    PREC_REL,
+    PREC_ADD,
+    PREC_MUL
+};
 
 // ============================================================
 // Conjuntos de sincronización
 // ============================================================
-const vector<int> SYNC_DECL = {T_FUN, T_ID, T_NL, T_EOF};
-const vector<int> SYNC_COMANDO = {T_NL, T_END, T_LOOP, T_ELSE, T_EOF};
-const vector<int> SYNC_EXP = {T_NL, ')', ',', ']', T_EOF};
+// Derivados de los FIRST y FOLLOW de la gramatica (ver gramatica.h). Son
+// bitsets por tipo de token: probar un token es un acceso a memoria.
+constexpr const ConjuntoTokens& SYNC_DECL = SINCRONIZACION_DECL;
+constexpr const ConjuntoTokens& SYNC_COMANDO = SINCRONIZACION_COMANDO;
+constexpr const ConjuntoTokens& SYNC_EXP = SINCRONIZACION_EXP;
 
 // ============================================================
 // Funciones auxiliares
 // ============================================================
-string nombreToken(int token) {
+// Avanza al siguiente token; T_EOF se repite indefinidamente. En modo
+// flujo los tokens se piden al lexer a medida que se agotan. Despues de
+// detenerse el analisis el lookahead queda en T_EOF.
+void avanzar(ParserContext& ctx) {
+    if (ctx.detenido) {
+        ctx.lookahead = T_EOF;
+        return;
+    }
+    if (ctx.posToken + 1 >= ctx.tokens.cantidad() && ctx.flujo != nullptr) {
+        recargarTokens(ctx);
+    }
+    if (ctx.posToken + 1 < ctx.tokens.cantidad()) {
+        ctx.posToken++;
+    }
+    ctx.lookahead = ctx.tokens.tipos[ctx.posToken];
+}
+
+// Token k posiciones despues del lookahead (k = 0 es el lookahead)
+int verToken(ParserContext& ctx, size_t k) {
+    if (ctx.detenido) {
+        return T_EOF;
+    }
+    while (ctx.posToken + k >= ctx.tokens.cantidad() && ctx.flujo != nullptr &&
+           recargarTokens(ctx)) {
+    }
+    size_t pos = ctx.posToken + k;
+    if (pos >= ctx.tokens.cantidad()) {
+        pos = ctx.tokens.cantidad() - 1;
+    }
+    return ctx.tokens.tipos[pos];
+}
+
+// "'c'" para los tokens de un caracter, que el lexer devuelve con su codigo
+struct NombresCaracteres {
+    char texto[T_NL][4] = {};
+};
+
+constexpr NombresCaracteres construirNombresCaracteres() {
+    NombresCaracteres nombres;
+    for (int c = 1; c < T_NL; c++) {
+        nombres.texto[c][0] = '\'';
+        nombres.texto[c][1] = (char)c;
+        nombres.texto[c][2] = '\'';
+    }
+    return nombres;
+}
+
+static constexpr NombresCaracteres NOMBRES_CARACTERES = construirNombresCaracteres();
+
+const char* nombreToken(int token) {
     switch(token) {
         case T_EOF: return "fin de archivo";
         case T_NL: return "salto de linea";
@@ -99,541 +139,725 @@ string nombreToken(int token) {
         case T_NE: return "<>";
         case T_ERROR: return "caracter no reconocido";
         default:
-            if (token > 0 && token < 256) {
-                return string("'") + (char)token + "'";
+            if (token > 0 && token < T_NL) {
+                return NOMBRES_CARACTERES.texto[token];
             }
             return "token desconocido";
     }
 }
 
-void errorSintactico(const char* esperado) {
+// Registra un error sobre el token i. El que completa ctx.maximoErrores
+// detiene el analisis.
+static void registrarError(ParserContext& ctx, CodigoError codigo, const char* esperado,
+                           size_t token, int encontrado, uint32_t valorEsperado = 0,
+                           uint32_t valorEncontrado = 0) {
     ErrorInfo error;
-    error.linea = tokenLinea;
-    
-    string encontrado;
-    if (lookahead == T_EOF) {
-        encontrado = "fin de archivo";
-    } else if (lookahead == T_NL) {
-        encontrado = "salto de linea";
-    } else if (lookahead == T_ERROR) {
-        encontrado = "caracter no reconocido";
-    } else if (yytext != nullptr && yytext[0] != '\0') {
-        encontrado = yytext;
-    } else {
-        encontrado = nombreToken(lookahead);
+    Posicion pos = ubicarToken(ctx.lineas, ctx.tokens, token);
+    error.linea = pos.linea;
+    error.columna = pos.columna;
+    error.token = (uint32_t)token;
+    error.offset = ctx.tokens.offsets[token];
+    error.longitud = ctx.tokens.longitudes[token];
+    error.codigo = codigo;
+    error.encontrado = (uint8_t)encontrado;
+    error.esperado = esperado;
+    error.valorEsperado = valorEsperado;
+    error.valorEncontrado = valorEncontrado;
+    error.lexema = 0;
+    if (ctx.flujo != nullptr) {
+        // El flujo descarta la fuente ya analizada: el lexema se copia
+        error.lexema = (uint32_t)ctx.lexemasErrores.size();
+        ctx.lexemasErrores.append(ctx.tokens.fuente + error.offset, error.longitud);
+        error.offset += (uint32_t)ctx.flujo->descartados;
+    }
+    ctx.errores.push_back(error);
+    ctx.hayErrores = true;
+    if (ctx.maximoErrores > 0 && ctx.errores.size() >= ctx.maximoErrores) {
+        ctx.detenido = true;
+        ctx.lookahead = T_EOF;
+    }
+}
+
+// Registra un error en la posicion del lookahead
+void agregarError(ParserContext& ctx, CodigoError codigo, const char* esperado) {
+    registrarError(ctx, codigo, esperado, ctx.posToken, ctx.lookahead);
+}
+
+void errorEnToken(ParserContext& ctx, CodigoError codigo, size_t token,
+                  uint32_t valorEsperado, uint32_t valorEncontrado) {
+    registrarError(ctx, codigo, nullptr, token, ctx.tokens.tipos[token], valorEsperado,
+                   valorEncontrado);
+}
+
+// Un error sobre el mismo token que el anterior de la declaracion es una
+// cascada de la recuperacion (por ejemplo el 'salto de linea' que falta
+// despues de un ':' que falto) y no se informa. No se compara con errores
+// de otras declaraciones, asi el resultado de cada una sigue dependiendo
+// solo de sus tokens (ver analizarDeclaraciones).
+void errorSintactico(ParserContext& ctx, const char* esperado) {
+    if (ctx.detenido) {
+        return;   // los errores tras detenerse son consecuencia del corte
+    }
+    if (ctx.tokenUltimoError == ctx.posToken) {
+        return;
     }
-    
-    error.mensaje = string("Se esperaba ") + esperado + 
-                    " pero se encontro '" + encontrado + "'";
-    errores.push_back(error);
-    hayErrores = true;
+    ctx.tokenUltimoError = ctx.posToken;
+    agregarError(ctx, ERROR_ESPERABA, esperado);
 }
 
-void sincronizar(const vector<int>& siguientes) {
-    int intentos = 0;
-    const int MAX_INTENTOS = 100;
-    
-    while (lookahead != T_EOF && intentos < MAX_INTENTOS) {
-        for (int token : siguientes) {
-            if (lookahead == token) {
-                return;
-            }
+// Entra a un nivel de anidamiento. Al superar profundidadMaxima informa un
+// unico error y detiene el analisis: la recursion no sigue creciendo y
+// todos los no terminales abiertos ven T_EOF y terminan.
+static bool entrarNivel(ParserContext& ctx) {
+    if (ctx.profundidad >= ctx.profundidadMaxima) {
+        if (!ctx.detenido) {
+            agregarError(ctx, ERROR_ANIDAMIENTO, nullptr);
+            ctx.detenido = true;
+            ctx.lookahead = T_EOF;
         }
-        lookahead = yylex();
-        intentos++;
+        return false;
     }
+    ctx.profundidad++;
+    return true;
 }
 
-void match(int expected) {
-    if (lookahead == expected) {
-        lookahead = yylex();
+// Capacidad inicial de ctx.errores: los de la mayoria de los archivos
+// entran sin volver a reservar
+static const size_t ERRORES_RESERVADOS = 256;
+
+size_t pilaNecesaria(const ParserContext& ctx) {
+    return (size_t)ctx.profundidadMaxima * BYTES_PILA_POR_NIVEL;
+}
+
+// Descarta tokens hasta uno de siguientes. Todos los conjuntos tienen
+// T_EOF, asi que termina.
+void sincronizar(ParserContext& ctx, const ConjuntoTokens& siguientes) {
+    while (!siguientes.contiene(ctx.lookahead)) {
+        avanzar(ctx);
+    }
+}
+
+void match(ParserContext& ctx, int expected) {
+    if (ctx.lookahead == expected) {
+        avanzar(ctx);
     } else {
-        errorSintactico(nombreToken(expected).c_str());
+        errorSintactico(ctx, nombreToken(expected));
     }
 }
 
-void skipNL() {
-    while (lookahead == T_NL) {
-        lookahead = yylex();
+void skipNL(ParserContext& ctx) {
+    while (ctx.lookahead == T_NL) {
+        avanzar(ctx);
     }
 }
 
+void iniciarParser(ParserContext& ctx) {
+    ctx.posToken = 0;
+    ctx.lineas.limpiar();
+    ctx.ast.reiniciar();
+    if (ctx.flujo != nullptr && ctx.tokens.cantidad() == 0) {
+        recargarTokens(ctx);
+    } else {
+        ctx.ast.reservar(ctx.tokens.cantidad());
+    }
+    ctx.lookahead = ctx.tokens.tipos[0];
+    ctx.errores.clear();
+    ctx.errores.reserve(ERRORES_RESERVADOS);
+    ctx.lexemasErrores.clear();
+    ctx.hayErrores = false;
+    ctx.profundidad = 0;
+    ctx.detenido = false;
+    ctx.tokenUltimoError = SIN_ERROR_PREVIO;
+}
+
 // ============================================================
 // GRAMÁTICA Mini-0
 // ============================================================
+// Cada no terminal devuelve el nodo que construyo (NODO_NULO si un error
+// impidio reconocerlo). Los que tienen una cantidad variable de hijos los
+// apilan en ctx.ast.pila y crean el nodo al final.
+
+// Byte y valor (SimboloId o numero) del lookahead, antes de consumirlo
+static inline uint32_t offsetToken(const ParserContext& ctx) {
+    return ctx.tokens.offsets[ctx.posToken];
+}
+
+static inline uint32_t valorToken(const ParserContext& ctx) {
+    return ctx.tokens.valores[ctx.posToken];
+}
 
 // programa -> { NL } decl { decl }
-void programa() {
-    skipNL();
+NodoId programa(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    size_t desde = ast.pila.size();
+    skipNL(ctx);
     
-    if (lookahead == T_EOF) {
-        errorSintactico("al menos una declaracion");
-        return;
+    if (ctx.lookahead == T_EOF) {
+        errorSintactico(ctx, "al menos una declaracion");
+        ast.raiz = ast.crear(N_PROGRAMA, 0, 0, 0, desde);
+        return ast.raiz;
     }
     
-    decl();
+    do {
+        // Sin retenerAst (modo flujo) cada declaracion se libera apenas se
+        // reconoce, asi la memoria no crece con la entrada
+        Ast::Marca marca = ast.marca();
+        ctx.tokenUltimoError = SIN_ERROR_PREVIO;
+        NodoId d = decl(ctx);
+        if (!ctx.retenerAst) {
+            ast.liberarHasta(marca);
+        } else if (d != NODO_NULO) {
+            ast.apilar(d);
+        }
+    } while (ctx.lookahead != T_EOF);
     
-    while (lookahead != T_EOF) {
-        decl();
+    ast.raiz = ast.crear(N_PROGRAMA, 0, 0, 0, desde);
+    return ast.raiz;
+}
+
+bool analizarDeclaraciones(ParserContext& ctx, vector<DeclAnalizada>& decls,
+                           const function<bool(size_t)>& parar) {
+    Ast& ast = ctx.ast;
+    while (ctx.lookahead != T_EOF) {
+        if (parar(ctx.posToken)) {
+            return true;
+        }
+        DeclAnalizada d;
+        d.primerToken = (uint32_t)ctx.posToken;
+        d.primerError = (uint32_t)ctx.errores.size();
+        d.primerNodo = (uint32_t)ast.cantidad();
+        size_t hijos = ast.hijos.size();
+        ctx.tokenUltimoError = SIN_ERROR_PREVIO;
+        d.nodo = decl(ctx);
+        d.cantidadNodos = (uint32_t)(ast.cantidad() - d.primerNodo);
+        d.cantidadHijos = (uint32_t)(ast.hijos.size() - hijos);
+        decls.push_back(d);
     }
+    return false;
 }
 
 // decl -> funcion | global
-void decl() {
-    if (lookahead == T_FUN) {
-        funcion();
-    } else if (lookahead == T_ID) {
-        globalDecl();
-    } else if (lookahead == T_ERROR) {
-        errorSintactico("declaracion valida");
-        lookahead = yylex();
-        skipNL();
+NodoId decl(ParserContext& ctx) {
+    if (ctx.lookahead == T_FUN) {
+        return funcion(ctx);
+    } else if (ctx.lookahead == T_ID) {
+        return globalDecl(ctx);
+    } else if (ctx.lookahead == T_ERROR) {
+        errorSintactico(ctx, "declaracion valida");
+        avanzar(ctx);
+        skipNL(ctx);
     } else {
-        errorSintactico("declaracion (fun o identificador)");
-        sincronizar(SYNC_DECL);
-        skipNL();
+        errorSintactico(ctx, "declaracion (fun o identificador)");
+        sincronizar(ctx, SYNC_DECL);
+        skipNL(ctx);
     }
+    return NODO_NULO;
 }
 
 // nl -> NL { NL }
-void nl() {
-    if (lookahead == T_NL) {
-        match(T_NL);
-        while (lookahead == T_NL) {
-            match(T_NL);
+void nl(ParserContext& ctx) {
+    if (ctx.lookahead == T_NL) {
+        match(ctx, T_NL);
+        while (ctx.lookahead == T_NL) {
+            match(ctx, T_NL);
         }
-    } else if (lookahead != T_EOF) {
-        errorSintactico("salto de linea");
-        sincronizar(SYNC_COMANDO);
+    } else if (ctx.lookahead != T_EOF) {
+        errorSintactico(ctx, "salto de linea");
+        sincronizar(ctx, SYNC_COMANDO);
     }
 }
 
 // global -> declvar nl
-void globalDecl() {
-    declvar();
-    nl();
+NodoId globalDecl(ParserContext& ctx) {
+    NodoId d = declvar(ctx);
+    nl(ctx);
+    return d;
 }
 
 // funcion -> 'fun' ID '(' params ')' [ ':' tipo ] nl bloque 'end' nl
-void funcion() {
-    match(T_FUN);
+NodoId funcion(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    match(ctx, T_FUN);
     
-    if (lookahead == T_ID) {
-        match(T_ID);
+    uint32_t offset = offsetToken(ctx);
+    uint32_t nombre = valorToken(ctx);
+    if (ctx.lookahead == T_ID) {
+        match(ctx, T_ID);
     } else {
-        errorSintactico("nombre de funcion");
-        sincronizar(SYNC_DECL);
-        return;
+        errorSintactico(ctx, "nombre de funcion");
+        sincronizar(ctx, SYNC_DECL);
+        return NODO_NULO;
     }
     
-    if (lookahead == '(') {
-        match('(');
+    if (ctx.lookahead == '(') {
+        match(ctx, '(');
     } else {
-        errorSintactico("'('");
+        errorSintactico(ctx, "'('");
     }
     
-    params();
+    size_t desde = ast.pila.size();
+    params(ctx);
     
-    if (lookahead == ')') {
-        match(')');
+    if (ctx.lookahead == ')') {
+        match(ctx, ')');
     } else {
-        errorSintactico("')'");
+        errorSintactico(ctx, "')'");
     }
     
-    if (lookahead == ':') {
-        match(':');
-        tipo();
+    NodoId retorno = NODO_NULO;
+    if (ctx.lookahead == ':') {
+        match(ctx, ':');
+        retorno = tipo(ctx);
     }
+    ast.apilar(retorno);
     
-    nl();
-    bloque();
+    nl(ctx);
+    NodoId cuerpo = bloque(ctx);
+    ast.apilar(cuerpo);
     
-    if (lookahead == T_END) {
-        match(T_END);
+    if (ctx.lookahead == T_END) {
+        match(ctx, T_END);
     } else {
-        errorSintactico("'end'");
-        sincronizar(SYNC_DECL);
+        errorSintactico(ctx, "'end'");
+        sincronizar(ctx, SYNC_DECL);
     }
     
-    nl();
+    nl(ctx);
+    return ast.crear(N_FUNCION, 0, offset, nombre, desde);
 }
 
 // bloque -> { declvar nl } { comando nl }
-void bloque() {
-    while (lookahead == T_ID) {
-        int savedLinea = tokenLinea;
-        match(T_ID);
+NodoId bloque(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    if (!entrarNivel(ctx)) {
+        return NODO_NULO;
+    }
+    uint32_t offsetBloque = offsetToken(ctx);
+    size_t desde = ast.pila.size();
+    
+    while (ctx.lookahead == T_ID) {
+        uint32_t offset = offsetToken(ctx);
+        uint32_t nombre = valorToken(ctx);
+        match(ctx, T_ID);
         
-        if (lookahead == ':') {
-            match(':');
-            tipo();
-            nl();
+        if (ctx.lookahead == ':') {
+            match(ctx, ':');
+            NodoId t = tipo(ctx);
+            ast.apilar(ast.unario(N_DECLVAR, 0, offset, nombre, t));
+            nl(ctx);
         } else {
-            if (lookahead == '=') {
-                match('=');
-                exp();
-                nl();
-            } else if (lookahead == '(') {
-                match('(');
-                listaexp();
-                if (lookahead == ')') {
-                    match(')');
-                } else {
-                    errorSintactico("')'");
+            // El primer comando que empieza con un identificador ya tiene
+            // el identificador consumido
+            if (ctx.lookahead == '=') {
+                uint32_t offsetIgual = offsetToken(ctx);
+                match(ctx, '=');
+                NodoId valor = exp(ctx);
+                NodoId destino = ast.hoja(N_VAR, 0, offset, nombre);
+                ast.apilar(ast.binario(N_ATRIB, 0, offsetIgual, destino, valor));
+                nl(ctx);
+            } else if (ctx.lookahead == '(') {
+                ast.apilar(llamada(ctx, offset, nombre));
+                nl(ctx);
+            } else if (ctx.lookahead == '[') {
+                NodoId destino = variable(ctx, offset, nombre);
+                uint32_t offsetIgual = offsetToken(ctx);
+                NodoId valor = NODO_NULO;
+                if (ctx.lookahead == '=') {
+                    match(ctx, '=');
+                    valor = exp(ctx);
                 }
-                nl();
-            } else if (lookahead == '[') {
-                while (lookahead == '[') {
-                    match('[');
-                    exp();
-                    if (lookahead == ']') {
-                        match(']');
-                    } else {
-                        errorSintactico("']'");
-                    }
-                }
-                if (lookahead == '=') {
-                    match('=');
-                    exp();
-                }
-                nl();
+                ast.apilar(ast.binario(N_ATRIB, 0, offsetIgual, destino, valor));
+                nl(ctx);
             } else {
-                errorSintactico("':' o '=' o '('");
-                sincronizar(SYNC_COMANDO);
-                if (lookahead == T_NL) nl();
+                errorSintactico(ctx, "':' o '=' o '('");
+                sincronizar(ctx, SYNC_COMANDO);
+                if (ctx.lookahead == T_NL) nl(ctx);
             }
             break;
         }
     }
     
-    while (lookahead == T_IF || lookahead == T_WHILE || 
-           lookahead == T_RETURN || lookahead == T_ID) {
-        comando();
-        nl();
+    while (ctx.lookahead == T_IF || ctx.lookahead == T_WHILE || 
+           ctx.lookahead == T_RETURN || ctx.lookahead == T_ID) {
+        NodoId c = comando(ctx);
+        if (c != NODO_NULO) {
+            ast.apilar(c);
+        }
+        nl(ctx);
     }
+    
+    ctx.profundidad--;
+    return ast.crear(N_BLOQUE, 0, offsetBloque, 0, desde);
 }
 
 // params -> /* vacio */ | parametro { ',' parametro }
-void params() {
-    if (lookahead == T_ID) {
-        parametro();
-        while (lookahead == ',') {
-            match(',');
-            parametro();
+// Apila los parametros reconocidos
+void params(ParserContext& ctx) {
+    if (ctx.lookahead == T_ID) {
+        NodoId p = parametro(ctx);
+        if (p != NODO_NULO) ctx.ast.apilar(p);
+        while (ctx.lookahead == ',') {
+            match(ctx, ',');
+            p = parametro(ctx);
+            if (p != NODO_NULO) ctx.ast.apilar(p);
         }
     }
 }
 
 // parametro -> ID ':' tipo
-void parametro() {
-    if (lookahead == T_ID) {
-        match(T_ID);
+NodoId parametro(ParserContext& ctx) {
+    uint32_t offset = offsetToken(ctx);
+    uint32_t nombre = valorToken(ctx);
+    if (ctx.lookahead == T_ID) {
+        match(ctx, T_ID);
     } else {
-        errorSintactico("nombre de parametro");
-        return;
+        errorSintactico(ctx, "nombre de parametro");
+        return NODO_NULO;
     }
     
-    if (lookahead == ':') {
-        match(':');
+    if (ctx.lookahead == ':') {
+        match(ctx, ':');
     } else {
-        errorSintactico("':'");
-        return;
+        errorSintactico(ctx, "':'");
+        return NODO_NULO;
     }
     
-    tipo();
+    NodoId t = tipo(ctx);
+    return ctx.ast.unario(N_PARAMETRO, 0, offset, nombre, t);
 }
 
 // tipo -> tipobase | '[' ']' tipo
-void tipo() {
-    if (lookahead == '[') {
-        match('[');
-        if (lookahead == ']') {
-            match(']');
+// Los '[' ']' se cuentan en un bucle: el nodo guarda la cantidad
+NodoId tipo(ParserContext& ctx) {
+    uint32_t offset = offsetToken(ctx);
+    uint32_t dimensiones = 0;
+    while (ctx.lookahead == '[') {
+        match(ctx, '[');
+        if (ctx.lookahead == ']') {
+            match(ctx, ']');
         } else {
-            errorSintactico("']'");
+            errorSintactico(ctx, "']'");
         }
-        tipo();
-    } else {
-        tipobase();
+        dimensiones++;
     }
+    int base = tipobase(ctx);
+    return ctx.ast.hoja(N_TIPO, base, offset, dimensiones);
 }
 
 // tipobase -> 'int' | 'bool' | 'char' | 'string'
-void tipobase() {
-    if (lookahead == T_INT || lookahead == T_BOOL || 
-        lookahead == T_CHAR || lookahead == T_STRING) {
-        match(lookahead);
+// Devuelve el token del tipo, o 0 si no hay tipo
+int tipobase(ParserContext& ctx) {
+    if (ctx.lookahead == T_INT || ctx.lookahead == T_BOOL || 
+        ctx.lookahead == T_CHAR || ctx.lookahead == T_STRING) {
+        int base = ctx.lookahead;
+        match(ctx, ctx.lookahead);
+        return base;
     } else {
-        errorSintactico("tipo (int, bool, char, string)");
+        errorSintactico(ctx, "tipo (int, bool, char, string)");
+        return 0;
     }
 }
 
 // declvar -> ID ':' tipo
-void declvar() {
-    if (lookahead == T_ID) {
-        match(T_ID);
+NodoId declvar(ParserContext& ctx) {
+    uint32_t offset = offsetToken(ctx);
+    uint32_t nombre = valorToken(ctx);
+    if (ctx.lookahead == T_ID) {
+        match(ctx, T_ID);
     } else {
-        errorSintactico("identificador");
-        return;
+        errorSintactico(ctx, "identificador");
+        return NODO_NULO;
     }
     
-    if (lookahead == ':') {
-        match(':');
+    if (ctx.lookahead == ':') {
+        match(ctx, ':');
     } else {
-        errorSintactico("':'");
-        return;
+        errorSintactico(ctx, "':'");
+        return NODO_NULO;
     }
     
-    tipo();
+    NodoId t = tipo(ctx);
+    return ctx.ast.unario(N_DECLVAR, 0, offset, nombre, t);
 }
 
 // comando -> cmdif | cmdwhile | cmdatrib | cmdreturn | llamada
-void comando() {
-    if (lookahead == T_IF) {
-        cmdif();
-    } else if (lookahead == T_WHILE) {
-        cmdwhile();
-    } else if (lookahead == T_RETURN) {
-        cmdreturn();
-    } else if (lookahead == T_ID) {
-        match(T_ID);
+NodoId comando(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    if (ctx.lookahead == T_IF) {
+        return cmdif(ctx);
+    } else if (ctx.lookahead == T_WHILE) {
+        return cmdwhile(ctx);
+    } else if (ctx.lookahead == T_RETURN) {
+        return cmdreturn(ctx);
+    } else if (ctx.lookahead == T_ID) {
+        uint32_t offset = offsetToken(ctx);
+        uint32_t nombre = valorToken(ctx);
+        match(ctx, T_ID);
         
-        while (lookahead == '[') {
-            match('[');
-            exp();
-            if (lookahead == ']') {
-                match(']');
-            } else {
-                errorSintactico("']'");
-            }
-        }
+        NodoId destino = variable(ctx, offset, nombre);
         
-        if (lookahead == '=') {
-            match('=');
-            exp();
-        } else if (lookahead == '(') {
-            match('(');
-            listaexp();
-            if (lookahead == ')') {
-                match(')');
-            } else {
-                errorSintactico("')'");
-            }
+        if (ctx.lookahead == '=') {
+            uint32_t offsetIgual = offsetToken(ctx);
+            match(ctx, '=');
+            NodoId valor = exp(ctx);
+            return ast.binario(N_ATRIB, 0, offsetIgual, destino, valor);
+        } else if (ctx.lookahead == '(') {
+            // 'a[i](...)' se acepta como llamada a 'a'
+            return llamada(ctx, offset, nombre);
         } else {
-            errorSintactico("'=' o '('");
+            errorSintactico(ctx, "'=' o '('");
         }
     } else {
-        errorSintactico("comando (if, while, return, identificador)");
-        sincronizar(SYNC_COMANDO);
+        errorSintactico(ctx, "comando (if, while, return, identificador)");
+        sincronizar(ctx, SYNC_COMANDO);
     }
+    return NODO_NULO;
 }
 
 // cmdif -> 'if' exp nl bloque { 'else' 'if' exp nl bloque } [ 'else' nl bloque ] 'end'
-void cmdif() {
-    match(T_IF);
-    exp();
-    nl();
-    bloque();
+NodoId cmdif(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    uint32_t offset = offsetToken(ctx);
+    size_t desde = ast.pila.size();
+    match(ctx, T_IF);
+    NodoId condicion = exp(ctx);
+    ast.apilar(condicion);
+    nl(ctx);
+    NodoId cuerpo = bloque(ctx);
+    ast.apilar(cuerpo);
     
-    while (lookahead == T_ELSE) {
-        match(T_ELSE);
+    while (ctx.lookahead == T_ELSE) {
+        match(ctx, T_ELSE);
         
-        if (lookahead == T_IF) {
-            match(T_IF);
-            exp();
-            nl();
-            bloque();
+        if (ctx.lookahead == T_IF) {
+            match(ctx, T_IF);
+            condicion = exp(ctx);
+            ast.apilar(condicion);
+            nl(ctx);
+            cuerpo = bloque(ctx);
+            ast.apilar(cuerpo);
         } else {
-            nl();
-            bloque();
+            nl(ctx);
+            cuerpo = bloque(ctx);
+            ast.apilar(cuerpo);
             break;
         }
     }
     
-    if (lookahead == T_END) {
-        match(T_END);
+    if (ctx.lookahead == T_END) {
+        match(ctx, T_END);
     } else {
-        errorSintactico("'end'");
+        errorSintactico(ctx, "'end'");
     }
+    return ast.crear(N_IF, 0, offset, 0, desde);
 }
 
 // cmdwhile -> 'while' exp nl bloque 'loop'
-void cmdwhile() {
-    match(T_WHILE);
-    exp();
-    nl();
-    bloque();
+NodoId cmdwhile(ParserContext& ctx) {
+    uint32_t offset = offsetToken(ctx);
+    match(ctx, T_WHILE);
+    NodoId condicion = exp(ctx);
+    nl(ctx);
+    NodoId cuerpo = bloque(ctx);
     
-    if (lookahead == T_LOOP) {
-        match(T_LOOP);
+    if (ctx.lookahead == T_LOOP) {
+        match(ctx, T_LOOP);
     } else {
-        errorSintactico("'loop'");
+        errorSintactico(ctx, "'loop'");
     }
+    return ctx.ast.binario(N_WHILE, 0, offset, condicion, cuerpo);
 }
 
 // cmdreturn -> 'return' exp | 'return'
-void cmdreturn() {
-    match(T_RETURN);
+NodoId cmdreturn(ParserContext& ctx) {
+    uint32_t offset = offsetToken(ctx);
+    match(ctx, T_RETURN);
     
-    if (lookahead != T_NL && lookahead != T_EOF) {
-        exp();
+    if (ctx.lookahead != T_NL && ctx.lookahead != T_EOF) {
+        NodoId valor = exp(ctx);
+        return ctx.ast.unario(N_RETURN, 0, offset, 0, valor);
     }
+    return ctx.ast.hoja(N_RETURN, 0, offset, 0);
 }
 
 // listaexp -> /* vacio */ | exp { ',' exp }
-void listaexp() {
-    if (lookahead != ')') {
-        exp();
-        while (lookahead == ',') {
-            match(',');
-            exp();
+// Apila las expresiones
+void listaexp(ParserContext& ctx) {
+    if (ctx.lookahead != ')') {
+        ctx.ast.apilar(exp(ctx));
+        while (ctx.lookahead == ',') {
+            match(ctx, ',');
+            ctx.ast.apilar(exp(ctx));
         }
     }
 }
 
-// ============================================================
-// EXPRESIONES (con precedencia correcta estilo C)
-// ============================================================
-
-void exp() {
-    expOr();
-}
-
-void expOr() {
-    expAnd();
-    expOrPrime();
-}
-
-void expOrPrime() {
-    if (lookahead == T_OR) {
-        match(T_OR);
-        expAnd();
-        expOrPrime();
-    }
-}
-
-void expAnd() {
-    expRel();
-    expAndPrime();
-}
-
-void expAndPrime() {
-    if (lookahead == T_AND) {
-        match(T_AND);
-        expRel();
-        expAndPrime();
+// llamada -> ID '(' listaexp ')', con el ID ya consumido
+NodoId llamada(ParserContext& ctx, uint32_t offset, uint32_t nombre) {
+    size_t desde = ctx.ast.pila.size();
+    match(ctx, '(');
+    listaexp(ctx);
+    if (ctx.lookahead == ')') {
+        match(ctx, ')');
+    } else {
+        errorSintactico(ctx, "')'");
     }
+    return ctx.ast.crear(N_LLAMADA, 0, offset, nombre, desde);
 }
 
-void expRel() {
-    expAdd();
-    expRelPrime();
-}
-
-void expRelPrime() {
-    if (lookahead == '<' || lookahead == '>' || 
-        lookahead == T_LE || lookahead == T_GE ||
-        lookahead == '=' || lookahead == T_NE) {
-        match(lookahead);
-        expAdd();
-        expRelPrime();
+// variable -> ID { '[' exp ']' }, con el ID ya consumido. Cada indice
+// envuelve al nodo anterior: a[i][j] es indexar(indexar(a, i), j)
+NodoId variable(ParserContext& ctx, uint32_t offset, uint32_t nombre) {
+    NodoId v = ctx.ast.hoja(N_VAR, 0, offset, nombre);
+    while (ctx.lookahead == '[') {
+        uint32_t offsetCorchete = offsetToken(ctx);
+        match(ctx, '[');
+        NodoId indice = exp(ctx);
+        if (ctx.lookahead == ']') {
+            match(ctx, ']');
+        } else {
+            errorSintactico(ctx, "']'");
+        }
+        v = ctx.ast.binario(N_INDEXAR, 0, offsetCorchete, v, indice);
     }
+    return v;
 }
 
-void expAdd() {
-    expMul();
-    expAddPrime();
-}
+// ============================================================
+// EXPRESIONES (con precedencia correcta estilo C)
+// ============================================================
 
-void expAddPrime() {
-    if (lookahead == '+' || lookahead == '-') {
-        match(lookahead);
-        expMul();
-        expAddPrime();
+// Toda subexpresion anidada (parentesis, indice, argumento, tamano de new)
+// pasa por aca, asi que es el unico punto que cuenta niveles
+NodoId exp(ParserContext& ctx) {
+    if (!entrarNivel(ctx)) {
+        return ctx.ast.hoja(N_ERROR, 0, offsetToken(ctx), 0);
     }
+    NodoId e = expBinaria(ctx, PREC_OR);
+    ctx.profundidad--;
+    return e;
 }
 
-void expMul() {
-    expUnary();
-    expMulPrime();
-}
-
-void expMulPrime() {
-    if (lookahead == '*' || lookahead == '/') {
-        match(lookahead);
-        expUnary();
-        expMulPrime();
-    }
-}
+// Nivel de precedencia de cada token como operador binario (0 si no lo
+// es), indexado por tipo de token. Todos asocian a izquierda; de menor a
+// mayor: or < and < relacionales < '+' '-' < '*' '/'
+struct TablaPrecedencia {
+    uint8_t nivel[256];
+};
 
-void expUnary() {
-    if (lookahead == T_NOT) {
-        match(T_NOT);
-        expUnary();
-    } else if (lookahead == '-') {
-        match('-');
-        expUnary();
-    } else {
-        expFactor();
-    }
-}
-
-void expFactor() {
-    if (lookahead == T_LITNUMERAL) {
-        match(T_LITNUMERAL);
-    } else if (lookahead == T_LITSTRING) {
-        match(T_LITSTRING);
-    } else if (lookahead == T_TRUE) {
-        match(T_TRUE);
-    } else if (lookahead == T_FALSE) {
-        match(T_FALSE);
-    } else if (lookahead == T_NEW) {
-        match(T_NEW);
-        if (lookahead == '[') {
-            match('[');
+constexpr TablaPrecedencia construirTablaPrecedencia() {
+    TablaPrecedencia tabla{};
+    tabla.nivel[T_OR] = PREC_OR;
+    tabla.nivel[T_AND] = PREC_AND;
+    tabla.nivel['<'] = tabla.nivel['>'] = PREC_REL;
+    tabla.nivel[T_LE] = tabla.nivel[T_GE] = PREC_REL;
+    tabla.nivel['='] = tabla.nivel[T_NE] = PREC_REL;
+    tabla.nivel['+'] = tabla.nivel['-'] = PREC_ADD;
+    tabla.nivel['*'] = tabla.nivel['/'] = PREC_MUL;
+    return tabla;
+}
+
+constexpr TablaPrecedencia TABLA_PRECEDENCIA = construirTablaPrecedencia();
+
+inline int precedenciaBinaria(int token) {
+    return TABLA_PRECEDENCIA.nivel[(uint8_t)token];
+}
+
+// Precedence climbing: reconoce operandos unidos por operadores de
+// precedencia >= minima. Los operadores de un mismo nivel se consumen en
+// el bucle, asi que la recursion solo crece con el cambio de nivel (a lo
+// sumo PREC_MUL llamadas por subexpresion) y no con la cantidad de
+// operadores. El arbol asocia a izquierda.
+NodoId expBinaria(ParserContext& ctx, int minima) {
+    NodoId izq = expUnary(ctx);
+    for (;;) {
+        int precedencia = precedenciaBinaria(ctx.lookahead);
+        if (precedencia < minima) {   // 0 (no es operador) siempre corta
+            break;
+        }
+        int op = ctx.lookahead;
+        uint32_t offset = offsetToken(ctx);
+        match(ctx, op);
+        NodoId der = expBinaria(ctx, precedencia + 1);
+        izq = ctx.ast.binario(N_BINARIA, op, offset, izq, der);
+    }
+    return izq;
+}
+
+// Los prefijos 'not' y '-' se consumen en un bucle, sin recursion: cada
+// nodo unario se crea con el hijo pendiente y se completa con el siguiente
+NodoId expUnary(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    NodoId primero = NODO_NULO, ultimo = NODO_NULO;
+    while (ctx.lookahead == T_NOT || ctx.lookahead == '-') {
+        NodoId u = ast.unario(N_UNARIA, ctx.lookahead, offsetToken(ctx), 0, NODO_NULO);
+        match(ctx, ctx.lookahead);
+        if (ultimo != NODO_NULO) {
+            ast.fijarHijo(ultimo, 0, u);
         } else {
-            errorSintactico("'['");
+            primero = u;
         }
-        exp();
-        if (lookahead == ']') {
-            match(']');
+        ultimo = u;
+    }
+    NodoId operando = expFactor(ctx);
+    if (ultimo == NODO_NULO) {
+        return operando;
+    }
+    ast.fijarHijo(ultimo, 0, operando);
+    return primero;
+}
+
+NodoId expFactor(ParserContext& ctx) {
+    Ast& ast = ctx.ast;
+    uint32_t offset = offsetToken(ctx);
+    uint32_t valor = valorToken(ctx);
+    if (ctx.lookahead == T_LITNUMERAL) {
+        match(ctx, T_LITNUMERAL);
+        return ast.hoja(N_NUMERO, 0, offset, valor);
+    } else if (ctx.lookahead == T_LITSTRING) {
+        match(ctx, T_LITSTRING);
+        return ast.hoja(N_STRING, 0, offset, valor);
+    } else if (ctx.lookahead == T_TRUE) {
+        match(ctx, T_TRUE);
+        return ast.hoja(N_BOOL, 0, offset, 1);
+    } else if (ctx.lookahead == T_FALSE) {
+        match(ctx, T_FALSE);
+        return ast.hoja(N_BOOL, 0, offset, 0);
+    } else if (ctx.lookahead == T_NEW) {
+        match(ctx, T_NEW);
+        if (ctx.lookahead == '[') {
+            match(ctx, '[');
         } else {
-            errorSintactico("']'");
+            errorSintactico(ctx, "'['");
         }
-        tipo();
-    } else if (lookahead == '(') {
-        match('(');
-        exp();
-        if (lookahead == ')') {
-            match(')');
+        NodoId tamano = exp(ctx);
+        if (ctx.lookahead == ']') {
+            match(ctx, ']');
         } else {
-            errorSintactico("')'");
+            errorSintactico(ctx, "']'");
         }
-    } else if (lookahead == T_ID) {
-        match(T_ID);
-        
-        if (lookahead == '(') {
-            match('(');
-            listaexp();
-            if (lookahead == ')') {
-                match(')');
-            } else {
-                errorSintactico("')'");
-            }
+        NodoId t = tipo(ctx);
+        return ast.binario(N_NEW, 0, offset, tamano, t);
+    } else if (ctx.lookahead == '(') {
+        match(ctx, '(');
+        NodoId e = exp(ctx);
+        if (ctx.lookahead == ')') {
+            match(ctx, ')');
         } else {
-            while (lookahead == '[') {
-                match('[');
-                exp();
-                if (lookahead == ']') {
-                    match(']');
-                } else {
-                    errorSintactico("']'");
-                }
-            }
+            errorSintactico(ctx, "')'");
+        }
+        return e;
+    } else if (ctx.lookahead == T_ID) {
+        match(ctx, T_ID);
+        
+        if (ctx.lookahead == '(') {
+            return llamada(ctx, offset, valor);
         }
+        return variable(ctx, offset, valor);
     } else {
-        errorSintactico("expresion");
-        sincronizar(SYNC_EXP);
+        errorSintactico(ctx, "expresion");
+        sincronizar(ctx, SYNC_EXP);
+        return ast.hoja(N_ERROR, 0, offset, 0);
     }
 }
 
@@ -641,19 +865,120 @@ void expFactor() {
 // Funciones de reporte de errores
 // ============================================================
 
-void mostrarErrores() {
-    if (!errores.empty()) {
-        cerr << "\n=== ERRORES SINTACTICOS ENCONTRADOS ===" << endl;
-        cerr << "Total de errores: " << errores.size() << "\n" << endl;
+void escribirEncontrado(const ParserContext& ctx, const ErrorInfo& error, string& salida) {
+    int tipo = error.encontrado;
+    if (tipo != T_EOF && tipo != T_NL && tipo != T_ERROR && error.longitud > 0) {
+        if (ctx.flujo != nullptr) {
+            salida.append(ctx.lexemasErrores, error.lexema, error.longitud);
+        } else {
+            salida.append(ctx.tokens.fuente + error.offset, error.longitud);
+        }
+    } else {
+        salida += nombreToken(tipo);
+    }
+}
+
+void escribirMensaje(const ParserContext& ctx, const ErrorInfo& error, string& salida) {
+    if (error.codigo == ERROR_ANIDAMIENTO) {
+        salida += "Anidamiento de mas de ";
+        salida += to_string(ctx.profundidadMaxima);
+        salida += " niveles; se detiene el analisis";
+        return;
+    }
+    switch (error.codigo) {
+        case ERROR_TIPO:
+            salida += "Se esperaba ";
+            escribirTipo(ctx.tipos, error.valorEsperado, salida);
+            salida += " pero la expresion es de tipo ";
+            escribirTipo(ctx.tipos, error.valorEncontrado, salida);
+            return;
+        case ERROR_NO_ES_ARREGLO:
+            salida += "Se indexa una expresion de tipo ";
+            escribirTipo(ctx.tipos, error.valorEncontrado, salida);
+            salida += ", que no es un arreglo";
+            return;
+        case ERROR_ARGUMENTOS:
+            salida += '\'';
+            escribirEncontrado(ctx, error, salida);
+            salida += "' recibe ";
+            salida += to_string(error.valorEsperado);
+            salida += error.valorEsperado == 1 ? " argumento" : " argumentos";
+            salida += " pero se le pasan ";
+            salida += to_string(error.valorEncontrado);
+            return;
+        case ERROR_SIN_VALOR:
+            salida += '\'';
+            escribirEncontrado(ctx, error, salida);
+            salida += "' no tiene tipo de retorno y se usa su valor";
+            return;
+        case ERROR_RETORNO:
+            if (error.valorEsperado == TIPO_VACIO) {
+                salida += "La funcion no tiene tipo de retorno pero 'return' devuelve un valor";
+            } else {
+                salida += "Falta el valor de retorno, de tipo ";
+                escribirTipo(ctx.tipos, error.valorEsperado, salida);
+            }
+            return;
+        case ERROR_SIN_ASIGNACION:
+            salida += "Falta '=' y el valor a asignar";
+            return;
+        case ERROR_DIVISION_CERO:
+            salida += "Division por cero";
+            return;
+        case ERROR_DESBORDE:
+            salida += error.encontrado == T_LITNUMERAL ? "El numero no entra en int"
+                    : "El resultado de la expresion constante no entra en int";
+            return;
+    }
+    if (esErrorSemantico(error.codigo)) {
+        salida += '\'';
+        escribirEncontrado(ctx, error, salida);
+        salida += error.codigo == ERROR_NO_DECLARADO ? "' no fue declarado"
+                : error.codigo == ERROR_REDECLARADO ? "' ya fue declarado en este alcance"
+                : error.codigo == ERROR_NO_ES_FUNCION ? "' no es una funcion"
+                : "' es una funcion, no una variable";
+        return;
+    }
+    salida += "Se esperaba ";
+    salida += error.esperado;
+    salida += " pero se encontro '";
+    escribirEncontrado(ctx, error, salida);
+    salida += '\'';
+}
+
+void mostrarErrores(const ParserContext& ctx, ostream& salida) {
+    if (!ctx.errores.empty()) {
+        // La pasada semantica solo corre sobre arboles sin errores
+        // sintacticos, asi que no se mezclan
+        salida << (esErrorSemantico(ctx.errores[0].codigo)
+                       ? "\n=== ERRORES SEMANTICOS ENCONTRADOS ===\n"
+                       : "\n=== ERRORES SINTACTICOS ENCONTRADOS ===\n");
+        salida << "Total de errores: " << ctx.errores.size() << "\n\n";
+        if (ctx.maximoErrores > 0 && ctx.errores.size() >= ctx.maximoErrores) {
+            salida << "(se detuvo el analisis al llegar a " << ctx.maximoErrores
+                   << " errores)\n\n";
+        }
         
-        for (size_t i = 0; i < errores.size(); i++) {
-            cerr << "Error " << (i + 1) << " [Linea " << errores[i].linea << "]: " 
-                 << errores[i].mensaje << endl;
+        // Un solo buffer para todas las lineas
+        string linea;
+        for (size_t i = 0; i < ctx.errores.size(); i++) {
+            const ErrorInfo& error = ctx.errores[i];
+            linea.clear();
+            linea += "Error ";
+            linea += to_string(i + 1);
+            linea += " [Linea ";
+            linea += to_string(error.linea);
+            linea += ", columna ";
+            linea += to_string(error.columna);
+            linea += "]: ";
+            escribirMensaje(ctx, error, linea);
+            linea += '\n';
+            salida << linea;
         }
-        cerr << "\n========================================" << endl;
+        salida << "\n========================================" << endl;
     }
 }
 
-bool tieneErrores() {
-    return hayErrores;
+bool tieneErrores(const ParserContext& ctx) {
+    return ctx.hayErrores;
 }
\ No newline at end of file
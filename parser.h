@@ -1,8 +1,141 @@
 #ifndef PARSER_H
 #define PARSER_H
 
-void programa();
-void mostrarErrores();
-bool tieneErrores();
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "interner.h"
+#include "tokenbuffer.h"
+#include "posicion.h"
+#include "ast.h"
+#include "tipos.h"
 
-#endif
\ No newline at end of file
+struct FlujoEntrada;
+
+// Anidamiento maximo por defecto de bloques (if/while) y expresiones
+// (parentesis, indices, argumentos). Cada nivel es un marco de recursion.
+const int PROFUNDIDAD_MAXIMA_DEFECTO = 1000;
+// Pila que se reserva por nivel de anidamiento. Un nivel de if o de
+// parentesis usa unos 300 bytes con -O2 y bastante mas con -O0 o con
+// AddressSanitizer; la reserva es memoria virtual que no se toca.
+const size_t BYTES_PILA_POR_NIVEL = 4096;
+// ParserContext::tokenUltimoError sin errores en la declaracion actual
+const size_t SIN_ERROR_PREVIO = SIZE_MAX;
+
+enum CodigoError : uint8_t {
+    ERROR_ESPERABA,         // "Se esperaba <esperado> pero se encontro <lookahead>"
+    ERROR_ANIDAMIENTO,      // se supero ctx.profundidadMaxima
+    // Semanticos (semantico.cpp), sobre el token de un nombre
+    ERROR_NO_DECLARADO,     // un uso sin declaracion visible
+    ERROR_REDECLARADO,      // otra declaracion del nombre en el mismo alcance
+    ERROR_NO_ES_FUNCION,    // se llama a una variable
+    ERROR_NO_ES_VARIABLE,   // una funcion usada como variable
+    // De tipos (semantico.cpp), sobre el token principal de la expresion
+    ERROR_TIPO,             // valorEsperado y valorEncontrado: TipoId en ctx.tipos
+    ERROR_NO_ES_ARREGLO,    // se indexa algo de tipo valorEncontrado
+    ERROR_ARGUMENTOS,       // valorEsperado parametros, valorEncontrado argumentos
+    ERROR_SIN_VALOR,        // se usa el valor de una funcion sin tipo de retorno
+    ERROR_RETORNO,          // falta el valor de tipo valorEsperado, o sobra si es TIPO_VACIO
+    ERROR_SIN_ASIGNACION,   // 'a[i]' sin '=' como primer comando de un bloque
+    // Del plegado de constantes (plegado.cpp), sobre el operador, y de
+    // semantico.cpp sobre un numeral
+    ERROR_DIVISION_CERO,
+    ERROR_DESBORDE          // el resultado o el literal no entra en int
+};
+
+inline bool esErrorSemantico(uint8_t codigo) {
+    return codigo >= ERROR_NO_DECLARADO;
+}
+
+// Un error sin texto: el mensaje se arma recien al mostrarlo (ver
+// escribirMensaje), asi registrarlo no reserva memoria
+struct ErrorInfo {
+    int linea;
+    int columna;
+    uint32_t token;         // lookahead al detectarlo (indice en ctx.tokens)
+    uint32_t offset;        // byte de la entrada donde empieza su lexema
+    uint32_t longitud;
+    uint32_t lexema;        // con flujo: donde quedo la copia del lexema en ctx.lexemasErrores
+    uint8_t codigo;         // CodigoError
+    uint8_t encontrado;     // tipo del lookahead
+    const char* esperado;   // texto estatico (un literal o nombreToken)
+    uint32_t valorEsperado; // errores de tipos: lo que indique su CodigoError
+    uint32_t valorEncontrado;
+};
+
+// Todo el estado de un analisis: flujo de tokens, lookahead y errores.
+// No hay estado global, asi que varios contextos pueden analizar archivos
+// distintos en hilos distintos sin sincronizacion.
+struct ParserContext {
+    Interner interner;              // simbolos de T_ID y T_LITSTRING
+    TokenBuffer tokens;             // flujo de tokens ya lexado
+    size_t posToken = 0;            // posicion del lookahead en tokens
+    int lookahead = 0;
+    IndiceLineas lineas;            // se construye con el primer error
+    Ast ast;                        // arbol que construye programa()
+    TablaTipos tipos;               // tipos de las pasadas semanticas, que citan los errores
+    bool retenerAst = true;         // false: liberar cada declaracion al terminarla
+    std::vector<ErrorInfo> errores;
+    std::string lexemasErrores;     // con flujo: copia de los lexemas que los errores citan
+    bool hayErrores = false;
+    FlujoEntrada* flujo = nullptr;  // entrada incremental; nullptr = tokens ya completos
+    int profundidad = 0;            // anidamiento actual de bloques y expresiones
+    int profundidadMaxima = PROFUNDIDAD_MAXIMA_DEFECTO;
+    size_t maximoErrores = 0;       // al llegar se detiene como con profundidadMaxima; 0 = sin limite
+    bool detenido = false;          // se supero profundidadMaxima o maximoErrores: el resto se ignora
+    size_t tokenUltimoError = SIN_ERROR_PREVIO;     // lookahead del ultimo error de la declaracion actual
+};
+
+// Deja el lookahead en el primer token de ctx.tokens y limpia los errores
+// y el arbol
+void iniciarParser(ParserContext& ctx);
+// Analiza el programa completo y deja el arbol en ctx.ast (ctx.ast.raiz)
+NodoId programa(ParserContext& ctx);
+// Lo mismo con el analizador de tabla LL(1) de ll1.cpp: sin recursion, asi
+// que no tiene limite de anidamiento (ignora ctx.profundidadMaxima)
+NodoId programaLL1(ParserContext& ctx);
+void mostrarErrores(const ParserContext& ctx, std::ostream& salida);
+// Agrega a salida el mensaje de un error de ctx.errores, o solo lo que se
+// encontro en vez de lo esperado: el lexema o el nombre del token
+void escribirMensaje(const ParserContext& ctx, const ErrorInfo& error, std::string& salida);
+void escribirEncontrado(const ParserContext& ctx, const ErrorInfo& error, std::string& salida);
+bool tieneErrores(const ParserContext& ctx);
+// Pila que necesita programa() para llegar a ctx.profundidadMaxima
+size_t pilaNecesaria(const ParserContext& ctx);
+// Nombre de un tipo de token para los mensajes, en memoria estatica
+const char* nombreToken(int token);
+
+// Comunes a los dos analizadores. esperado tiene que ser estatico: el
+// error guarda el puntero.
+void avanzar(ParserContext& ctx);
+void errorSintactico(ParserContext& ctx, const char* esperado);
+// Registra un error sobre el token i de ctx.tokens completos (no en modo
+// flujo), para las pasadas que recorren el arbol ya construido
+void errorEnToken(ParserContext& ctx, CodigoError codigo, size_t token,
+                  uint32_t valorEsperado = 0, uint32_t valorEncontrado = 0);
+
+// Una llamada a decl() del bucle de programa(): donde empezo y lo que produjo
+struct DeclAnalizada {
+    uint32_t primerToken;   // indice en ctx.tokens
+    uint32_t primerError;   // indice en ctx.errores
+    uint32_t primerNodo;    // los nodos que creo estan en [primerNodo, +cantidadNodos)
+    uint32_t cantidadNodos;
+    uint32_t cantidadHijos;
+    NodoId nodo;            // NODO_NULO si no se reconocio
+};
+
+// Para analizar solo parte de un archivo (incremental.cpp, paralelo.cpp):
+// el bucle de programa() sin el nodo N_PROGRAMA, que corre decl() desde el
+// lookahead hasta T_EOF y registra cada llamada en decls. Antes de cada una
+// consulta parar(ctx.posToken): si devuelve true se detiene y devuelve true.
+// skipNL salta los saltos de linea que preceden a la primera declaracion.
+// Los errores en cascada se suprimen solo dentro de cada declaracion, asi
+// que lo que registra una depende solo de los tokens desde su comienzo.
+bool analizarDeclaraciones(ParserContext& ctx, std::vector<DeclAnalizada>& decls,
+                           const std::function<bool(size_t)>& parar);
+void skipNL(ParserContext& ctx);
+
+#endif
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdint>
+#include "plegado.h"
+#include "tokens.h"
+
+static const int64_t MINIMO_INT = INT32_MIN;
+static const int64_t MAXIMO_INT = INT32_MAX;
+
+static bool esLiteral(const Nodo& nodo) {
+    return nodo.tipo == N_NUMERO || nodo.tipo == N_BOOL;
+}
+
+static int64_t entero(const Nodo& nodo) {
+    return (int32_t)nodo.valor;
+}
+
+static void errorEnNodo(ParserContext& ctx, CodigoError codigo, NodoId id) {
+    errorEnToken(ctx, codigo, tokenEn(ctx, ctx.ast.nodo(id).offset));
+}
+
+// ============================================================
+// Operaciones
+// ============================================================
+
+// Convierte id en una hoja con el valor calculado
+static void reemplazar(Semantica& semantica, Nodo& nodo, TipoNodo tipo, uint32_t valor) {
+    semantica.plegadas++;
+    semantica.nodosEliminados += nodo.cantidadHijos;
+    nodo.tipo = tipo;
+    nodo.op = 0;
+    nodo.valor = valor;
+    nodo.cantidadHijos = 0;
+}
+
+// Un resultado de int, si entra
+static void reemplazarEntero(ParserContext& ctx, Semantica& semantica, NodoId id,
+                             int64_t valor) {
+    if (valor < MINIMO_INT || valor > MAXIMO_INT) {
+        errorEnNodo(ctx, ERROR_DESBORDE, id);
+        return;
+    }
+    reemplazar(semantica, ctx.ast.nodos[id], N_NUMERO, (uint32_t)(int32_t)valor);
+}
+
+static void plegarUnaria(ParserContext& ctx, Semantica& semantica, NodoId id) {
+    const Nodo& operando = ctx.ast.nodo(ctx.ast.hijo(id, 0));
+    if (!esLiteral(operando)) {
+        return;
+    }
+    if (ctx.ast.nodo(id).op == T_NOT) {
+        reemplazar(semantica, ctx.ast.nodos[id], N_BOOL, !operando.valor);
+    } else {
+        reemplazarEntero(ctx, semantica, id, -entero(operando));
+    }
+}
+
+static void plegarBinaria(ParserContext& ctx, Semantica& semantica, NodoId id) {
+    const Ast& ast = ctx.ast;
+    const Nodo& izq = ast.nodo(ast.hijo(id, 0));
+    const Nodo& der = ast.nodo(ast.hijo(id, 1));
+    // Dividir por un cero literal es un error aunque el dividendo no sea constante
+    if (ast.nodo(id).op == '/' && der.tipo == N_NUMERO && der.valor == 0) {
+        errorEnNodo(ctx, ERROR_DIVISION_CERO, id);
+        return;
+    }
+    if (!esLiteral(izq) || !esLiteral(der)) {
+        return;
+    }
+    // Los bools (en '=' '<>' 'and' 'or') valen 0 o 1
+    int64_t a = izq.tipo == N_BOOL ? izq.valor : entero(izq);
+    int64_t b = der.tipo == N_BOOL ? der.valor : entero(der);
+    Nodo& nodo = ctx.ast.nodos[id];
+    switch (nodo.op) {
+        case '+': reemplazarEntero(ctx, semantica, id, a + b); return;
+        case '-': reemplazarEntero(ctx, semantica, id, a - b); return;
+        case '*': reemplazarEntero(ctx, semantica, id, a * b); return;
+        case '/':
+            // b no es 0. En 64 bits INT32_MIN / -1 no desborda y da fuera de rango
+            reemplazarEntero(ctx, semantica, id, a / b);
+            return;
+        case '<': reemplazar(semantica, nodo, N_BOOL, a < b); return;
+        case '>': reemplazar(semantica, nodo, N_BOOL, a > b); return;
+        case T_LE: reemplazar(semantica, nodo, N_BOOL, a <= b); return;
+        case T_GE: reemplazar(semantica, nodo, N_BOOL, a >= b); return;
+        case '=': reemplazar(semantica, nodo, N_BOOL, a == b); return;
+        case T_NE: reemplazar(semantica, nodo, N_BOOL, a != b); return;
+        case T_AND: reemplazar(semantica, nodo, N_BOOL, a && b); return;
+        case T_OR: reemplazar(semantica, nodo, N_BOOL, a || b); return;
+    }
+}
+
+// ============================================================
+// Recorrido
+// ============================================================
+
+bool plegarConstantes(ParserContext& ctx, Semantica& semantica) {
+    Ast& ast = ctx.ast;
+    size_t erroresPrevios = ctx.errores.size();
+    semantica.plegadas = 0;
+    semantica.nodosEliminados = 0;
+    if (ast.raiz == NODO_NULO) {
+        return true;
+    }
+
+    // Postorden iterativo, como el de verificarFuncion: cada operador se
+    // pliega despues que sus operandos. Los unarios se crean antes que su
+    // operando (ver expUnary), asi que el orden de los ids no sirve.
+    struct Pendiente {
+        NodoId id;
+        bool hijosListos;
+    };
+    std::vector<Pendiente> pendientes;
+    pendientes.push_back({ast.raiz, false});
+    while (!pendientes.empty() && !ctx.detenido) {
+        Pendiente p = pendientes.back();
+        pendientes.pop_back();
+        const Nodo& nodo = ast.nodo(p.id);
+        if (p.hijosListos) {
+            if (nodo.tipo == N_BINARIA) {
+                plegarBinaria(ctx, semantica, p.id);
+            } else {
+                plegarUnaria(ctx, semantica, p.id);
+            }
+            continue;
+        }
+        if (nodo.tipo == N_BINARIA || nodo.tipo == N_UNARIA) {
+            pendientes.push_back({p.id, true});
+        }
+        // Las hojas no se apilan: son la mayoria de los nodos
+        for (uint32_t i = nodo.cantidadHijos; i-- > 0;) {
+            NodoId h = ast.hijo(p.id, i);
+            if (h == NODO_NULO) {
+                continue;
+            }
+            if (ast.nodo(h).cantidadHijos > 0) {
+                pendientes.push_back({h, false});
+            }
+        }
+    }
+    // Un operador se informa despues que los de su operando derecho
+    std::stable_sort(ctx.errores.begin() + erroresPrevios, ctx.errores.end(),
+                     [](const ErrorInfo& a, const ErrorInfo& b) { return a.token < b.token; });
+    return ctx.errores.size() == erroresPrevios;
+}
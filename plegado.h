@@ -0,0 +1,25 @@
+#ifndef PLEGADO_H
+#define PLEGADO_H
+
+#include "parser.h"
+#include "semantico.h"
+
+// Plegado de constantes: reemplaza en ctx.ast cada operacion cuyos
+// operandos son literales por el literal de su resultado, de las hojas
+// hacia arriba, asi (5 + 3) * 2 - 10 / 2 queda en un N_NUMERO 11. Pliega
+// la aritmetica de int ('+' '-' '*' '/' y el '-' unario), las
+// comparaciones de numeros y de bools, 'not', 'and' y 'or'. Los
+// hexadecimales ya llegan como N_NUMERO con su valor.
+// int es de 32 bits con signo: una division por un cero constante (aunque
+// el dividendo no lo sea) y un resultado fuera de rango se registran en
+// ctx.errores, y esa operacion (y las que la contienen) queda sin plegar.
+// La division trunca hacia cero, como en C.
+// Supone un arbol sin errores de tipos (ver verificarPrograma): los
+// operandos literales de cada operador son del tipo que espera y los
+// numerales entran en int. Los nodos
+// reemplazados conservan su id y su offset; sus hijos quedan fuera del
+// arbol y se cuentan en semantica.nodosEliminados.
+// Devuelve false si hubo errores.
+bool plegarConstantes(ParserContext& ctx, Semantica& semantica);
+
+#endif
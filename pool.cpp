@@ -0,0 +1,110 @@
+#include <deque>
+#include <mutex>
+#include <pthread.h>
+#include <thread>
+#include <vector>
+#include "pool.h"
+
+unsigned hilosPorDefecto() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+// Cola de tareas de un hilo. El dueno trabaja por el final y los ladrones
+// por el frente, asi rara vez compiten por la misma tarea.
+struct ColaTareas {
+    std::mutex mutex;
+    std::deque<size_t> tareas;
+
+    bool tomarFinal(size_t& tarea) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tareas.empty()) return false;
+        tarea = tareas.back();
+        tareas.pop_back();
+        return true;
+    }
+
+    bool robarFrente(size_t& tarea) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tareas.empty()) return false;
+        tarea = tareas.front();
+        tareas.pop_front();
+        return true;
+    }
+};
+
+static void trabajador(std::vector<ColaTareas>& colas, unsigned id,
+                       const std::function<void(size_t, unsigned)>& tarea) {
+    size_t n = colas.size();
+    size_t actual;
+    for (;;) {
+        if (colas[id].tomarFinal(actual)) {
+            tarea(actual, id);
+            continue;
+        }
+        // Cola propia vacia: recorrer las demas empezando por la siguiente.
+        // Como no se crean tareas nuevas, si todas estan vacias se termino.
+        bool robada = false;
+        for (size_t k = 1; k < n && !robada; k++) {
+            robada = colas[(id + k) % n].robarFrente(actual);
+        }
+        if (!robada) return;
+        tarea(actual, id);
+    }
+}
+
+void ejecutarEnParalelo(size_t cantidad, unsigned hilos,
+                        const std::function<void(size_t)>& tarea) {
+    ejecutarEnParalelo(cantidad, hilos, [&tarea](size_t i, unsigned) { tarea(i); });
+}
+
+void ejecutarEnParalelo(size_t cantidad, unsigned hilos,
+                        const std::function<void(size_t, unsigned)>& tarea) {
+    if (hilos > cantidad) hilos = (unsigned)cantidad;
+    if (hilos <= 1) {
+        for (size_t i = 0; i < cantidad; i++) {
+            tarea(i, 0);
+        }
+        return;
+    }
+
+    // Reparto inicial en bloques contiguos; el desbalance (archivos de
+    // tamanos muy distintos) se corrige robando
+    std::vector<ColaTareas> colas(hilos);
+    for (unsigned h = 0; h < hilos; h++) {
+        size_t desde = cantidad * h / hilos;
+        size_t hasta = cantidad * (h + 1) / hilos;
+        for (size_t i = desde; i < hasta; i++) {
+            colas[h].tareas.push_back(i);
+        }
+    }
+
+    std::vector<std::thread> otros;
+    for (unsigned h = 1; h < hilos; h++) {
+        otros.emplace_back(trabajador, std::ref(colas), h, std::cref(tarea));
+    }
+    trabajador(colas, 0, tarea);
+    for (std::thread& t : otros) {
+        t.join();
+    }
+}
+
+static void* correrTarea(void* tarea) {
+    (*static_cast<const std::function<void()>*>(tarea))();
+    return nullptr;
+}
+
+bool ejecutarConPila(size_t bytesPila, const std::function<void()>& tarea) {
+    // std::thread no permite elegir el tamano de la pila
+    pthread_attr_t atributos;
+    pthread_t hilo;
+    bool creado = pthread_attr_init(&atributos) == 0 &&
+                  pthread_attr_setstacksize(&atributos, bytesPila) == 0 &&
+                  pthread_create(&hilo, &atributos, correrTarea,
+                                 const_cast<std::function<void()>*>(&tarea)) == 0;
+    pthread_attr_destroy(&atributos);
+    if (creado) {
+        pthread_join(hilo, nullptr);
+    }
+    return creado;
+}
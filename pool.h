@@ -0,0 +1,35 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <functional>
+
+// Cantidad de hilos por defecto: los nucleos disponibles (al menos 1)
+unsigned hilosPorDefecto();
+
+// Mayor cantidad de hilos que se acepta en -j/--hilos
+const unsigned MAXIMO_HILOS = 1024;
+
+// Ejecuta tarea(i) para cada i en [0, cantidad) sobre un pool de hilos con
+// robo de trabajo y espera a que terminen todas. Cada hilo tiene su propia
+// cola: toma tareas del final de la suya y, cuando se vacia, roba del
+// frente de la de otro hilo. El hilo que llama participa como hilo 0.
+// Las tareas no deben compartir estado mutable entre si.
+void ejecutarEnParalelo(size_t cantidad, unsigned hilos,
+                        const std::function<void(size_t)>& tarea);
+
+// Lo mismo pasando tambien el numero del hilo que ejecuta cada tarea, en
+// [0, hilos), para que las tareas usen memoria de trabajo de su hilo
+void ejecutarEnParalelo(size_t cantidad, unsigned hilos,
+                        const std::function<void(size_t, unsigned)>& tarea);
+
+// Pila que se puede suponer en cualquier hilo (el principal y los de
+// ejecutarEnParalelo tienen la de glibc, normalmente 8 MB)
+const size_t PILA_SEGURA = 4 * 1024 * 1024;
+
+// Ejecuta tarea() en un hilo nuevo con una pila de al menos bytesPila y
+// espera a que termine. Devuelve false, sin ejecutarla, si no se pudo
+// crear el hilo (por ejemplo si no hay memoria para esa pila).
+bool ejecutarConPila(size_t bytesPila, const std::function<void()>& tarea);
+
+#endif
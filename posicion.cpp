@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cstring>
+#include "posicion.h"
+#include "tokenbuffer.h"
+
+void IndiceLineas::limpiar() {
+    saltos.clear();
+    construido = false;
+    lineasPrevias = 0;
+    columnaInicial = 0;
+}
+
+// Una pasada con memchr (vectorizado en la libc) sobre toda la fuente
+static void construir(IndiceLineas& indice, const char* fuente, size_t longitud) {
+    indice.saltos.clear();
+    const char* p = fuente;
+    const char* fin = fuente + longitud;
+    while (p < fin) {
+        const char* nl = (const char*)memchr(p, '\n', fin - p);
+        if (nl == nullptr) {
+            break;
+        }
+        indice.saltos.push_back((uint32_t)(nl - fuente));
+        p = nl + 1;
+    }
+    indice.construido = true;
+}
+
+Posicion ubicarToken(IndiceLineas& indice, const TokenBuffer& tokens, size_t i) {
+    if (!indice.construido) {
+        construir(indice, tokens.fuente, tokens.longitudFuente);
+    }
+    uint32_t inicio = tokens.offsets[i];
+    uint32_t fin = inicio + tokens.longitudes[i];
+
+    // Saltos de linea antes del final del lexema
+    size_t anteriores = std::lower_bound(indice.saltos.begin(), indice.saltos.end(), fin) -
+                        indice.saltos.begin();
+    Posicion pos;
+    pos.linea = (int)(indice.lineasPrevias + anteriores + 1);
+    if (anteriores > 0) {
+        uint32_t inicioLinea = indice.saltos[anteriores - 1] + 1;
+        pos.columna = (int)(std::max(inicio, inicioLinea) - inicioLinea + 1);
+    } else {
+        pos.columna = (int)(indice.columnaInicial + inicio + 1);
+    }
+    return pos;
+}
+
+void reemplazarEnIndice(IndiceLineas& indice, const char* fuente, size_t inicio,
+                        size_t finViejo, size_t finNuevo) {
+    if (!indice.construido) {
+        return;     // se construira completo cuando haga falta
+    }
+    std::vector<uint32_t>& s = indice.saltos;
+    auto desde = std::lower_bound(s.begin(), s.end(), (uint32_t)inicio);
+    auto hasta = std::lower_bound(desde, s.end(), (uint32_t)finViejo);
+    uint32_t delta = (uint32_t)(finNuevo - finViejo);   // modulo 2^32 si achica
+    for (auto it = hasta; it != s.end(); ++it) {
+        *it += delta;
+    }
+
+    std::vector<uint32_t> nuevos;
+    const char* p = fuente + inicio;
+    const char* fin = fuente + finNuevo;
+    while (p < fin) {
+        const char* nl = (const char*)memchr(p, '\n', fin - p);
+        if (nl == nullptr) {
+            break;
+        }
+        nuevos.push_back((uint32_t)(nl - fuente));
+        p = nl + 1;
+    }
+    size_t i = desde - s.begin();
+    s.erase(desde, hasta);
+    s.insert(s.begin() + i, nuevos.begin(), nuevos.end());
+}
+
+void descartarPrefijo(IndiceLineas& indice, const char* datos, size_t cantidad) {
+    const char* ultimo = nullptr;
+    const char* p = datos;
+    const char* fin = datos + cantidad;
+    while (p < fin) {
+        const char* nl = (const char*)memchr(p, '\n', fin - p);
+        if (nl == nullptr) {
+            break;
+        }
+        indice.lineasPrevias++;
+        ultimo = nl;
+        p = nl + 1;
+    }
+    if (ultimo != nullptr) {
+        indice.columnaInicial = (uint32_t)(fin - ultimo - 1);
+    } else {
+        indice.columnaInicial += (uint32_t)cantidad;
+    }
+    indice.construido = false;
+}
@@ -0,0 +1,47 @@
+#ifndef POSICION_H
+#define POSICION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TokenBuffer;
+
+// Linea y columna (desde 1, columna en bytes) para los mensajes de error
+struct Posicion {
+    int linea;
+    int columna;
+};
+
+// Indice de los saltos de linea de la fuente de un TokenBuffer. Los tokens
+// solo guardan offsets: el indice se construye la primera vez que hace
+// falta una posicion (al reportar el primer error) y cada consulta es una
+// busqueda binaria. Un archivo sin errores nunca cuenta lineas.
+struct IndiceLineas {
+    std::vector<uint32_t> saltos;   // offset de cada '\n' de la fuente
+    bool construido = false;
+
+    // En modo flujo la fuente es una ventana de la entrada; esto describe
+    // lo que ya se descarto antes de su primer byte
+    uint32_t lineasPrevias = 0;     // '\n' descartados
+    uint32_t columnaInicial = 0;    // bytes descartados desde el ultimo '\n'
+
+    void limpiar();
+};
+
+// Posicion del token i: la de su primer byte, salvo que el lexema incluya
+// saltos de linea (T_NL, strings multilinea), en cuyo caso la del comienzo
+// de su ultima linea. Asi la linea es la del final del lexema, como la que
+// reportaba yylineno.
+Posicion ubicarToken(IndiceLineas& indice, const TokenBuffer& tokens, size_t i);
+
+// Actualiza un indice ya construido cuando los bytes [inicio, finViejo) de
+// la fuente se reemplazaron por los que ahora ocupan [inicio, finNuevo).
+// Solo recorre los saltos: la fuente se escanea en el tramo nuevo.
+void reemplazarEnIndice(IndiceLineas& indice, const char* fuente, size_t inicio,
+                        size_t finViejo, size_t finNuevo);
+
+// Registra que se descartan los primeros bytes de la fuente (modo flujo)
+void descartarPrefijo(IndiceLineas& indice, const char* datos, size_t cantidad);
+
+#endif
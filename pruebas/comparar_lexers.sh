@@ -0,0 +1,89 @@
+#!/bin/bash
+# Prueba diferencial de los lexers: compila el parser y corre
+# --comparar-lexers (el DFA de flex contra lexersimd.cpp) sobre cada
+# archivo de pruebas/ y sobre un corpus generado al azar. Termina con error
+# en la primera diferencia, mostrando el archivo (que no se borra) y el
+# token.
+#
+# uso: pruebas/comparar_lexers.sh [archivos generados] [semilla]
+set -u
+
+cantidad=${1:-300}
+semilla=${2:-1}
+raiz=$(cd "$(dirname "$0")/.." && pwd)
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+echo "Compilando..."
+if ! g++ -std=c++17 -O2 -pthread -o "$tmp/parser" "$raiz"/*.cpp 2>"$tmp/compilacion"; then
+    cat "$tmp/compilacion"
+    exit 1
+fi
+
+comparar() {
+    if ! "$tmp/parser" --comparar-lexers "$1" >/dev/null 2>"$tmp/diferencia"; then
+        echo "FALLA: $1"
+        cat "$tmp/diferencia"
+        # El archivo queda para reproducir la diferencia
+        trap - EXIT
+        exit 1
+    fi
+}
+
+for f in "$raiz"/pruebas/*.m0; do
+    comparar "$f"
+done
+echo "pruebas/: los lexers coinciden"
+
+# Cada archivo es una mezcla de fragmentos validos e invalidos, con los
+# casos de borde de los dos lexers: escapes y comillas sin cerrar,
+# delimitadores de comentario, corridas de mas de 32 bytes (los bloques de
+# lexersimd), '\r', '\0' y bytes no ASCII
+mkdir -p "$tmp/corpus"
+LC_ALL=C awk -v cantidad="$cantidad" -v semilla="$semilla" -v dir="$tmp/corpus" '
+function azar(n) { return int(rand() * n) }
+function repetir(s, n,    r) { r = ""; while (n-- > 0) r = r s; return r }
+function fragmento(    k) {
+    k = azar(30)
+    if (k == 0) return repetir("a", 1 + azar(80))
+    if (k == 1) return "x" azar(100000) "_" repetir("Z9", azar(20))
+    if (k == 2) return azar(2147483647) ""
+    if (k == 3) return sprintf("0x%X", azar(2147483647))
+    if (k == 4) return "0x"
+    if (k == 5) return "\"" repetir("texto ", azar(12)) "\""
+    if (k == 6) return "\"a\\\"b\\\\\""
+    if (k == 7) return "\"sin cerrar" repetir(" ", azar(40))
+    if (k == 8) return "// comentario" repetir(" //", azar(15)) "\n"
+    if (k == 9) return "/* " repetir("* / *", azar(10)) " */"
+    if (k == 10) return "/* sin cerrar"
+    if (k == 11) return repetir(" ", 1 + azar(70))
+    if (k == 12) return repetir("\t", 1 + azar(40))
+    if (k == 13) return "\n" repetir(" ", azar(50))
+    if (k == 14) return "\r\n"
+    if (k == 15) return sprintf("%c", 128 + azar(128))
+    if (k == 16) return sprintf("%c", 0)
+    if (k == 17) return substr(">=<=<>()[],:=<>+-*/", 1 + azar(19), 1 + azar(3))
+    if (k == 18) return "@#$%&!?;{}"
+    if (k == 19) return "\"" repetir("\\n", azar(40)) "\""
+    if (k == 20) return "/*\n" repetir("linea\n", azar(10)) "*/"
+    if (k == 21) return azar(10) "abc"
+    split("if else end while loop fun return new string int char bool true false and or not", p, " ")
+    return p[1 + azar(17)]
+}
+BEGIN {
+    srand(semilla)
+    for (i = 0; i < cantidad; i++) {
+        archivo = sprintf("%s/g%04d.m0", dir, i)
+        n = azar(400)
+        for (j = 0; j < n; j++) {
+            printf "%s", fragmento() > archivo
+            if (azar(3) == 0) printf " " > archivo
+        }
+        close(archivo)
+    }
+}'
+
+for f in "$tmp"/corpus/*.m0; do
+    comparar "$f"
+done
+echo "corpus generado ($cantidad archivos, semilla $semilla): los lexers coinciden"
@@ -0,0 +1,665 @@
+#include <algorithm>
+#include <atomic>
+#include "semantico.h"
+#include "pool.h"
+#include "tokens.h"
+
+// Varias tareas por hilo, para que el robo de trabajo empareje funciones
+// de distinto tamano
+static const size_t TAREAS_POR_HILO = 16;
+// Con menos nodos por tarea no se amortiza copiar la tabla del programa
+static const size_t MINIMO_NODOS_TAREA = 16 * 1024;
+
+// Un error encontrado al recorrer. Se registran en ctx.errores recien al
+// final (registrarErrores): en paralelo cada tarea junta los suyos sin
+// tocar el contexto.
+struct ErrorPendiente {
+    uint32_t token;
+    uint8_t codigo;             // CodigoError
+    uint32_t valorEsperado;
+    uint32_t valorEncontrado;
+};
+
+// Lo que usa quien recorre declaraciones. En paralelo hay uno por tarea,
+// con la copia de la tabla de su hilo; el arbol, ctx.tipos y las firmas
+// solo se leen.
+struct Recorrido {
+    ParserContext& ctx;
+    Semantica& semantica;
+    TablaSimbolos& tabla;
+    std::vector<ErrorPendiente>& errores;
+    size_t limiteErrores;       // al llegar se deja de recorrer; 0 = sin limite
+    size_t declaraciones = 0;
+    size_t busquedas = 0;
+    size_t expresiones = 0;
+};
+
+static bool agotado(const Recorrido& r) {
+    return r.limiteErrores > 0 && r.errores.size() >= r.limiteErrores;
+}
+
+size_t tokenEn(const ParserContext& ctx, uint32_t offset) {
+    const std::vector<uint32_t>& offsets = ctx.tokens.offsets;
+    return (size_t)(std::lower_bound(offsets.begin(), offsets.end(), offset) - offsets.begin());
+}
+
+static void errorEnNodo(Recorrido& r, CodigoError codigo, NodoId id,
+                        uint32_t valorEsperado = 0, uint32_t valorEncontrado = 0) {
+    r.errores.push_back({(uint32_t)tokenEn(r.ctx, r.ctx.ast.nodo(id).offset), (uint8_t)codigo,
+                         valorEsperado, valorEncontrado});
+}
+
+// ============================================================
+// Literales
+// ============================================================
+
+static int valorDigito(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Si el numeral en p entra en int. Los lexers guardan (int)strtol o atoi,
+// que no avisan cuando no entra: se vuelve a leer el texto. El numeral
+// termina en el primer caracter que no es un digito de su base (la fuente
+// termina en '\0').
+static bool numeralEnRango(const char* p) {
+    int base = 10;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        base = 16;
+        p += 2;
+    }
+    int64_t valor = 0;
+    for (int digito; (digito = valorDigito(*p)) >= 0 && digito < base; p++) {
+        valor = valor * base + digito;
+        if (valor > INT32_MAX) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================
+// Nombres
+// ============================================================
+
+// El tipo escrito en un N_TIPO; TIPO_VACIO si no hay (retorno omitido)
+static TipoId tipoEscrito(ParserContext& ctx, NodoId id) {
+    if (id == NODO_NULO) {
+        return TIPO_VACIO;
+    }
+    const Nodo& nodo = ctx.ast.nodo(id);
+    return tipoDe(ctx.tipos, tipoBasico(nodo.op), nodo.valor);
+}
+
+// Los vinculos guardan el tipo de lo que declaran (ver Vinculo::tipo), asi
+// cada uso lo encuentra en la tabla sin volver a la declaracion, que puede
+// estar en cualquier lugar del arbol
+static void declararNodo(Recorrido& r, NodoId id, ClaseSimbolo clase, uint32_t tipo) {
+    r.declaraciones++;
+    if (!declarar(r.tabla, r.ctx.ast.nodo(id).valor, clase, id, tipo)) {
+        errorEnNodo(r, ERROR_REDECLARADO, id);
+    }
+}
+
+// Declara una funcion con su firma
+static void declararFuncion(Recorrido& r, NodoId id) {
+    // [parametro..., retorno, bloque]
+    const Ast& ast = r.ctx.ast;
+    uint32_t parametros = ast.nodo(id).cantidadHijos - 2;
+    Firma firma{(uint32_t)r.semantica.tiposParametros.size(), parametros,
+                tipoEscrito(r.ctx, ast.hijo(id, parametros))};
+    for (uint32_t i = 0; i < parametros; i++) {
+        r.semantica.tiposParametros.push_back(tipoEscrito(r.ctx, ast.hijo(ast.hijo(id, i), 0)));
+    }
+    r.semantica.firmas.push_back(firma);
+    declararNodo(r, id, SIMBOLO_FUNCION, (uint32_t)(r.semantica.firmas.size() - 1));
+}
+
+// Resuelve el nombre de un N_VAR o un N_LLAMADA. Devuelve su vinculo si es
+// de la clase que corresponde al uso.
+static const Vinculo* resolverUso(Recorrido& r, NodoId id) {
+    const Nodo& nodo = r.ctx.ast.nodo(id);
+    r.busquedas++;
+    const Vinculo* v = buscar(r.tabla, nodo.valor);
+    if (v == nullptr) {
+        errorEnNodo(r, ERROR_NO_DECLARADO, id);
+        return nullptr;
+    }
+    r.semantica.declaracion[id] = v->declaracion;
+    bool esFuncion = v->clase == SIMBOLO_FUNCION;
+    if (nodo.tipo == N_LLAMADA && !esFuncion) {
+        errorEnNodo(r, ERROR_NO_ES_FUNCION, id);
+        return nullptr;
+    }
+    if (nodo.tipo == N_VAR && esFuncion) {
+        errorEnNodo(r, ERROR_NO_ES_VARIABLE, id);
+        return nullptr;
+    }
+    return v;
+}
+
+// ============================================================
+// Tipos
+// ============================================================
+// Las expresiones se evaluan en postorden con una pila de tipos: cada hoja
+// apila el suyo y cada operador desapila los de sus operandos y apila el
+// resultado.
+
+static bool compatibles(TipoId a, TipoId b) {
+    return a == b || a == TIPO_ERROR || b == TIPO_ERROR || (esNumerico(a) && esNumerico(b));
+}
+
+// Tipo de la expresion id, que se va a usar como valor
+static TipoId valorDe(Recorrido& r, NodoId id, TipoId t) {
+    if (t == TIPO_VACIO) {
+        errorEnNodo(r, ERROR_SIN_VALOR, id);
+        return TIPO_ERROR;
+    }
+    return t;
+}
+
+// Devuelve false si t no es compatible con esperado (y lo informa sobre la
+// expresion id) o si ya era TIPO_ERROR
+static bool exigir(Recorrido& r, NodoId id, TipoId t, TipoId esperado) {
+    if (!compatibles(t, esperado)) {
+        errorEnNodo(r, ERROR_TIPO, id, esperado, t);
+        return false;
+    }
+    return t != TIPO_ERROR;
+}
+
+// Desapila el tipo de la expresion hijo y lo exige como valor de tipo esperado
+static bool operando(Recorrido& r, std::vector<TipoId>& valores, NodoId hijo,
+                     TipoId esperado) {
+    TipoId t = valorDe(r, hijo, valores.back());
+    valores.pop_back();
+    return exigir(r, hijo, t, esperado);
+}
+
+// El tipo de un operador: si un operando tiene otro tipo no se sabe que
+// quiso decir, y con TIPO_ERROR no se informa nada mas sobre lo que lo contiene
+static TipoId resultado(bool operandosBien, TipoId t) {
+    return operandosBien ? t : TIPO_ERROR;
+}
+
+static TipoId tipoLlamada(Recorrido& r, NodoId id,
+                          std::vector<TipoId>& valores) {
+    const Ast& ast = r.ctx.ast;
+    const Nodo& llamada = ast.nodo(id);
+    size_t primero = valores.size() - llamada.cantidadHijos;
+    for (uint32_t i = 0; i < llamada.cantidadHijos; i++) {
+        valores[primero + i] = valorDe(r, ast.hijo(id, i), valores[primero + i]);
+    }
+    // Los argumentos no cambian los alcances: sigue visible lo que se
+    // resolvio al visitar la llamada
+    TipoId t = TIPO_ERROR;
+    const Vinculo* v = buscar(r.tabla, llamada.valor);
+    if (v != nullptr && v->clase == SIMBOLO_FUNCION) {
+        const Firma& firma = r.semantica.firmas[v->tipo];
+        if (firma.parametros != llamada.cantidadHijos) {
+            errorEnNodo(r, ERROR_ARGUMENTOS, id, firma.parametros, llamada.cantidadHijos);
+        } else {
+            for (uint32_t i = 0; i < firma.parametros; i++) {
+                exigir(r, ast.hijo(id, i), valores[primero + i],
+                       r.semantica.tiposParametros[firma.primerParametro + i]);
+            }
+        }
+        t = firma.retorno;
+    }
+    valores.resize(primero);
+    return t;
+}
+
+// Desapila los tipos de los hijos de id y devuelve el suyo
+static TipoId combinar(Recorrido& r, NodoId id,
+                       std::vector<TipoId>& valores) {
+    const Ast& ast = r.ctx.ast;
+    const Nodo& nodo = ast.nodo(id);
+    switch (nodo.tipo) {
+        case N_LLAMADA:
+            return tipoLlamada(r, id, valores);
+        case N_INDEXAR: {
+            operando(r, valores, ast.hijo(id, 1), TIPO_INT);
+            NodoId arreglo = ast.hijo(id, 0);
+            TipoId t = valorDe(r, arreglo, valores.back());
+            valores.pop_back();
+            if (t == TIPO_ERROR) {
+                return TIPO_ERROR;
+            }
+            if (!esArreglo(r.ctx.tipos, t)) {
+                errorEnNodo(r, ERROR_NO_ES_ARREGLO, arreglo, 0, t);
+                return TIPO_ERROR;
+            }
+            return elementoDe(r.ctx.tipos, t);
+        }
+        case N_NEW:
+            operando(r, valores, ast.hijo(id, 0), TIPO_INT);
+            return arregloDe(r.ctx.tipos, tipoEscrito(r.ctx, ast.hijo(id, 1)));
+        case N_UNARIA:
+            if (nodo.op == T_NOT) {
+                return resultado(operando(r, valores, ast.hijo(id, 0), TIPO_BOOL), TIPO_BOOL);
+            }
+            return resultado(operando(r, valores, ast.hijo(id, 0), TIPO_INT), TIPO_INT);
+        case N_BINARIA: {
+            // Los dos operandos se desapilan aunque el derecho ya tenga un error
+            NodoId izq = ast.hijo(id, 0);
+            NodoId der = ast.hijo(id, 1);
+            switch (nodo.op) {
+                case T_OR: case T_AND:
+                    return resultado(operando(r, valores, der, TIPO_BOOL) &
+                                     operando(r, valores, izq, TIPO_BOOL), TIPO_BOOL);
+                case '=': case T_NE: {
+                    // Cualquier tipo, el mismo de los dos lados
+                    TipoId t = valorDe(r, der, valores.back());
+                    valores.pop_back();
+                    TipoId tipoIzq = valorDe(r, izq, valores.back());
+                    valores.pop_back();
+                    return resultado(tipoIzq != TIPO_ERROR && exigir(r, der, t, tipoIzq),
+                                     TIPO_BOOL);
+                }
+                case '<': case '>': case T_LE: case T_GE:
+                    return resultado(operando(r, valores, der, TIPO_INT) &
+                                     operando(r, valores, izq, TIPO_INT), TIPO_BOOL);
+                default:
+                    return resultado(operando(r, valores, der, TIPO_INT) &
+                                     operando(r, valores, izq, TIPO_INT), TIPO_INT);
+            }
+        }
+        default:
+            return TIPO_ERROR;
+    }
+}
+
+// ============================================================
+// Funciones
+// ============================================================
+// Cada funcion se recorre una vez: los nombres se resuelven en orden, al
+// llegar a cada uso, y los tipos se combinan al salir de cada expresion.
+// El recorrido es iterativo, como imprimirAst: las expresiones pueden
+// anidarse tanto como permita el parser de tabla.
+
+enum AccionRecorrido : uint8_t {
+    VISITAR,
+    VISITAR_CUERPO,     // bloque de una funcion: sigue en el alcance de los parametros
+    CERRAR_ALCANCE,
+    COMBINAR,           // los tipos de los hijos ya estan apilados
+    CONDICION,          // desapila el tipo de la condicion de un if o un while
+    DESCARTAR           // desapila el valor de una llamada usada como comando
+};
+
+struct Pendiente {
+    NodoId nodo;
+    uint8_t accion;
+};
+
+// Los comandos de un N_ATRIB o un N_RETURN, una vez evaluadas sus expresiones
+static void terminarComando(Recorrido& r, NodoId id, TipoId retorno,
+                            std::vector<TipoId>& valores) {
+    const Ast& ast = r.ctx.ast;
+    if (ast.nodo(id).tipo == N_ATRIB) {
+        // [destino, exp]
+        NodoId valor = ast.hijo(id, 1);
+        TipoId t = TIPO_ERROR;
+        if (valor != NODO_NULO) {
+            t = valorDe(r, valor, valores.back());
+            valores.pop_back();
+        }
+        TipoId destino = valores.back();
+        valores.pop_back();
+        if (valor != NODO_NULO) {
+            exigir(r, valor, t, destino);
+        } else {
+            // El parser acepta 'a[i]' sin '=' solo como primer comando de
+            // un bloque; mas adelante es un error sintactico. Se ubica en
+            // el ultimo '[' del destino: el token del N_ATRIB es el salto
+            // de linea, que se informa en la linea siguiente
+            errorEnNodo(r, ERROR_SIN_ASIGNACION, ast.hijo(id, 0));
+        }
+    } else if (retorno == TIPO_VACIO) {
+        valores.pop_back();
+        errorEnNodo(r, ERROR_RETORNO, id, TIPO_VACIO);
+    } else {
+        operando(r, valores, ast.hijo(id, 0), retorno);
+    }
+}
+
+static void verificarFuncion(Recorrido& r, NodoId funcion, std::vector<Pendiente>& pendientes,
+                             std::vector<TipoId>& valores) {
+    const Ast& ast = r.ctx.ast;
+    const Nodo& f = ast.nodo(funcion);
+    uint32_t parametros = f.cantidadHijos - 2;
+    TipoId retorno = tipoEscrito(r.ctx, ast.hijo(funcion, parametros));
+    pendientes.clear();
+    valores.clear();
+
+    abrirAlcance(r.tabla);
+    for (uint32_t i = 0; i < parametros && !agotado(r); i++) {
+        NodoId p = ast.hijo(funcion, i);
+        declararNodo(r, p, SIMBOLO_PARAMETRO, tipoEscrito(r.ctx, ast.hijo(p, 0)));
+    }
+    pendientes.push_back({NODO_NULO, CERRAR_ALCANCE});
+    NodoId cuerpo = ast.hijo(funcion, parametros + 1);
+    if (cuerpo != NODO_NULO) {
+        pendientes.push_back({cuerpo, VISITAR_CUERPO});
+    }
+
+    while (!pendientes.empty() && !agotado(r)) {
+        Pendiente p = pendientes.back();
+        pendientes.pop_back();
+        switch (p.accion) {
+            case CERRAR_ALCANCE:
+                cerrarAlcance(r.tabla);
+                continue;
+            case CONDICION:
+                operando(r, valores, p.nodo, TIPO_BOOL);
+                continue;
+            case DESCARTAR:
+                valores.pop_back();
+                continue;
+            case COMBINAR:
+                if (ast.nodo(p.nodo).tipo == N_ATRIB || ast.nodo(p.nodo).tipo == N_RETURN) {
+                    terminarComando(r, p.nodo, retorno, valores);
+                } else {
+                    valores.push_back(combinar(r, p.nodo, valores));
+                }
+                continue;
+        }
+        const Nodo& nodo = ast.nodo(p.nodo);
+        switch (nodo.tipo) {
+            case N_BLOQUE:
+                // [declvar..., comando...]: las declaraciones salen primero
+                if (p.accion == VISITAR) {
+                    abrirAlcance(r.tabla);
+                    pendientes.push_back({NODO_NULO, CERRAR_ALCANCE});
+                }
+                for (uint32_t i = nodo.cantidadHijos; i-- > 0;) {
+                    NodoId h = ast.hijo(p.nodo, i);
+                    if (h == NODO_NULO) {
+                        continue;
+                    }
+                    if (ast.nodo(h).tipo == N_LLAMADA) {
+                        pendientes.push_back({h, DESCARTAR});
+                    }
+                    pendientes.push_back({h, VISITAR});
+                }
+                break;
+            case N_DECLVAR:
+                declararNodo(r, p.nodo, SIMBOLO_LOCAL,
+                             tipoEscrito(r.ctx, ast.hijo(p.nodo, 0)));
+                break;
+            case N_IF:
+                // [cond, bloque, {cond, bloque}, [bloque else]]
+                for (uint32_t i = nodo.cantidadHijos; i-- > 0;) {
+                    NodoId h = ast.hijo(p.nodo, i);
+                    if (i % 2 == 0 && i + 1 < nodo.cantidadHijos) {
+                        pendientes.push_back({h, CONDICION});
+                    }
+                    pendientes.push_back({h, VISITAR});
+                }
+                break;
+            case N_WHILE:
+                pendientes.push_back({ast.hijo(p.nodo, 1), VISITAR});
+                pendientes.push_back({ast.hijo(p.nodo, 0), CONDICION});
+                pendientes.push_back({ast.hijo(p.nodo, 0), VISITAR});
+                break;
+            case N_RETURN:
+                if (nodo.cantidadHijos > 0) {
+                    pendientes.push_back({p.nodo, COMBINAR});
+                    pendientes.push_back({ast.hijo(p.nodo, 0), VISITAR});
+                } else if (retorno != TIPO_VACIO) {
+                    errorEnNodo(r, ERROR_RETORNO, p.nodo, retorno);
+                }
+                break;
+            case N_ATRIB:
+                pendientes.push_back({p.nodo, COMBINAR});
+                if (ast.hijo(p.nodo, 1) != NODO_NULO) {
+                    pendientes.push_back({ast.hijo(p.nodo, 1), VISITAR});
+                }
+                pendientes.push_back({ast.hijo(p.nodo, 0), VISITAR});
+                break;
+            case N_NUMERO:
+                r.expresiones++;
+                // Fuera de rango no se sigue con el valor truncado: es de tipo error
+                if (!numeralEnRango(r.ctx.tokens.fuente + nodo.offset)) {
+                    errorEnNodo(r, ERROR_DESBORDE, p.nodo);
+                    valores.push_back(TIPO_ERROR);
+                    break;
+                }
+                valores.push_back(TIPO_INT);
+                break;
+            case N_STRING:
+                r.expresiones++;
+                valores.push_back(TIPO_STRING);
+                break;
+            case N_BOOL:
+                r.expresiones++;
+                valores.push_back(TIPO_BOOL);
+                break;
+            case N_VAR: {
+                r.expresiones++;
+                const Vinculo* v = resolverUso(r, p.nodo);
+                valores.push_back(v != nullptr ? v->tipo : TIPO_ERROR);
+                break;
+            }
+            case N_LLAMADA:
+                resolverUso(r, p.nodo);
+                r.expresiones++;
+                pendientes.push_back({p.nodo, COMBINAR});
+                for (uint32_t i = nodo.cantidadHijos; i-- > 0;) {
+                    pendientes.push_back({ast.hijo(p.nodo, i), VISITAR});
+                }
+                break;
+            case N_NEW:
+                // El tipo no es una expresion
+                r.expresiones++;
+                pendientes.push_back({p.nodo, COMBINAR});
+                pendientes.push_back({ast.hijo(p.nodo, 0), VISITAR});
+                break;
+            case N_INDEXAR: case N_BINARIA: case N_UNARIA:
+                r.expresiones++;
+                pendientes.push_back({p.nodo, COMBINAR});
+                for (uint32_t i = nodo.cantidadHijos; i-- > 0;) {
+                    pendientes.push_back({ast.hijo(p.nodo, i), VISITAR});
+                }
+                break;
+            default:
+                // N_ERROR: no quedan en un arbol sin errores sintacticos
+                r.expresiones++;
+                valores.push_back(TIPO_ERROR);
+                break;
+        }
+    }
+    // Si se detuvo quedan alcances abiertos: la tabla puede seguir en uso
+    // para las funciones de otra tarea
+    for (const Pendiente& p : pendientes) {
+        if (p.accion == CERRAR_ALCANCE) {
+            cerrarAlcance(r.tabla);
+        }
+    }
+}
+
+// ============================================================
+// Programa
+// ============================================================
+
+// Verifica funciones[desde, hasta)
+static void verificarFunciones(Recorrido& r, const std::vector<NodoId>& funciones, size_t desde,
+                               size_t hasta) {
+    std::vector<Pendiente> pendientes;
+    std::vector<TipoId> valores;
+    for (size_t i = desde; i < hasta && !agotado(r); i++) {
+        verificarFuncion(r, funciones[i], pendientes, valores);
+    }
+}
+
+// Los cuerpos crean tipos ([]t de cada new [n] t y los de las variables
+// locales) y en paralelo ctx.tipos solo puede leerse: antes se crean todos
+// los que puede pedir un cuerpo, que son los escritos en el arbol con una
+// dimension mas.
+static void internarTiposEscritos(ParserContext& ctx, unsigned hilos) {
+    const std::vector<Nodo>& nodos = ctx.ast.nodos;
+    // Por parte y tipo basico, las dimensiones mas 1 del mayor arreglo
+    // escrito; 0 si no aparece
+    std::vector<uint32_t> maximos(hilos * CANTIDAD_TIPOS_BASICOS, 0);
+    ejecutarEnParalelo(hilos, hilos, [&](size_t parte) {
+        uint32_t maximo[CANTIDAD_TIPOS_BASICOS] = {};
+        size_t hasta = nodos.size() * (parte + 1) / hilos;
+        for (size_t i = nodos.size() * parte / hilos; i < hasta; i++) {
+            if (nodos[i].tipo == N_TIPO) {
+                TipoId base = tipoBasico(nodos[i].op);
+                maximo[base] = std::max(maximo[base], nodos[i].valor + 1);
+            }
+        }
+        std::copy(maximo, maximo + CANTIDAD_TIPOS_BASICOS,
+                  maximos.begin() + parte * CANTIDAD_TIPOS_BASICOS);
+    });
+    for (size_t i = 0; i < maximos.size(); i++) {
+        if (maximos[i] > 0) {
+            tipoDe(ctx.tipos, (TipoId)(i % CANTIDAD_TIPOS_BASICOS), maximos[i]);
+        }
+    }
+}
+
+// Funciones consecutivas que verifica una tarea, con sus propios errores
+struct TareaSemantica {
+    size_t desde;
+    size_t hasta;
+    std::vector<ErrorPendiente> errores;
+    size_t declaraciones = 0;
+    size_t busquedas = 0;
+    size_t expresiones = 0;
+};
+
+// Reparte las funciones en tareas. Cada hilo las verifica con su copia de
+// la tabla tal como quedo despues del alcance del programa: una funcion
+// solo agrega alcances que cierra al terminar. Los errores se juntan en el
+// orden de las tareas, el mismo en que los encontraria el recorrido en
+// secuencia.
+static void verificarEnParalelo(Recorrido& programa, const std::vector<NodoId>& funciones,
+                                size_t cantidadTareas, unsigned hilos) {
+    ParserContext& ctx = programa.ctx;
+    Semantica& semantica = programa.semantica;
+    // Mas hilos que tareas no tendrian que hacer, y cada uno copia la tabla
+    hilos = (unsigned)std::min<size_t>(hilos, cantidadTareas);
+    internarTiposEscritos(ctx, hilos);
+    size_t limite = programa.limiteErrores;
+    if (limite > 0) {
+        limite -= programa.errores.size();
+    }
+
+    std::vector<TareaSemantica> tareas(cantidadTareas);
+    semantica.tablasHilos.resize(hilos);
+    std::vector<char> copiada(hilos, 0);
+    // Los errores de las tareas que siguen a una que llego al limite no se
+    // van a registrar
+    std::atomic<size_t> primeraAgotada(cantidadTareas);
+    ejecutarEnParalelo(cantidadTareas, hilos, [&](size_t i, unsigned hilo) {
+        if (i > primeraAgotada.load(std::memory_order_relaxed)) {
+            return;
+        }
+        TablaSimbolos& tabla = semantica.tablasHilos[hilo];
+        if (!copiada[hilo]) {
+            tabla = semantica.tabla;
+            copiada[hilo] = 1;
+        }
+        TareaSemantica& tarea = tareas[i];
+        Recorrido r{ctx, semantica, tabla, tarea.errores, limite};
+        verificarFunciones(r, funciones, funciones.size() * i / cantidadTareas,
+                           funciones.size() * (i + 1) / cantidadTareas);
+        tarea.declaraciones = r.declaraciones;
+        tarea.busquedas = r.busquedas;
+        tarea.expresiones = r.expresiones;
+        if (agotado(r)) {
+            size_t anterior = primeraAgotada.load(std::memory_order_relaxed);
+            while (i < anterior && !primeraAgotada.compare_exchange_weak(anterior, i)) {
+            }
+        }
+    });
+
+    for (TareaSemantica& tarea : tareas) {
+        programa.errores.insert(programa.errores.end(), tarea.errores.begin(),
+                                tarea.errores.end());
+        programa.declaraciones += tarea.declaraciones;
+        programa.busquedas += tarea.busquedas;
+        programa.expresiones += tarea.expresiones;
+    }
+}
+
+// Registra los errores en el orden de los tokens. Con un limite quedan los
+// primeros que encontro el recorrido: las declaraciones repetidas del
+// programa se encuentran antes que los errores de las funciones que las
+// preceden.
+static void registrarErrores(ParserContext& ctx, std::vector<ErrorPendiente>& errores,
+                             size_t limite) {
+    if (limite > 0 && errores.size() > limite) {
+        errores.resize(limite);
+    }
+    std::stable_sort(errores.begin(), errores.end(),
+                     [](const ErrorPendiente& a, const ErrorPendiente& b) {
+                         return a.token < b.token;
+                     });
+    for (const ErrorPendiente& e : errores) {
+        errorEnToken(ctx, (CodigoError)e.codigo, e.token, e.valorEsperado, e.valorEncontrado);
+    }
+}
+
+bool verificarPrograma(ParserContext& ctx, Semantica& semantica, unsigned hilos) {
+    const Ast& ast = ctx.ast;
+    size_t erroresPrevios = ctx.errores.size();
+    iniciarTabla(semantica.tabla, ctx.interner.cantidad());
+    iniciarTipos(ctx.tipos);
+    semantica.declaracion.assign(ast.cantidad(), NODO_NULO);
+    semantica.firmas.clear();
+    semantica.tiposParametros.clear();
+    semantica.declaraciones = 0;
+    semantica.busquedas = 0;
+    semantica.expresiones = 0;
+    semantica.tareas = 0;
+    if (ast.raiz == NODO_NULO) {
+        return true;
+    }
+
+    size_t limite = 0;
+    if (ctx.maximoErrores > 0) {
+        if (erroresPrevios >= ctx.maximoErrores) {
+            return true;
+        }
+        limite = ctx.maximoErrores - erroresPrevios;
+    }
+    std::vector<ErrorPendiente> errores;
+    Recorrido programa{ctx, semantica, semantica.tabla, errores, limite};
+
+    // Primero todo el alcance del programa, asi una funcion puede usar las
+    // que se declaran despues
+    const Nodo& nodoPrograma = ast.nodo(ast.raiz);
+    std::vector<NodoId> funciones;
+    abrirAlcance(semantica.tabla);
+    for (uint32_t i = 0; i < nodoPrograma.cantidadHijos && !agotado(programa); i++) {
+        NodoId d = ast.hijo(ast.raiz, i);
+        if (d == NODO_NULO) {
+            continue;
+        }
+        if (ast.nodo(d).tipo == N_FUNCION) {
+            declararFuncion(programa, d);
+            funciones.push_back(d);
+        } else {
+            declararNodo(programa, d, SIMBOLO_GLOBAL, tipoEscrito(ctx, ast.hijo(d, 0)));
+        }
+    }
+
+    size_t cantidadTareas = std::min({funciones.size(), (size_t)hilos * TAREAS_POR_HILO,
+                                      ast.cantidad() / MINIMO_NODOS_TAREA});
+    if (hilos > 1 && cantidadTareas > 1 && !agotado(programa)) {
+        semantica.tareas = cantidadTareas;
+        verificarEnParalelo(programa, funciones, cantidadTareas, hilos);
+    } else {
+        verificarFunciones(programa, funciones, 0, funciones.size());
+    }
+    semantica.declaraciones = programa.declaraciones;
+    semantica.busquedas = programa.busquedas;
+    semantica.expresiones = programa.expresiones;
+    registrarErrores(ctx, errores, limite);
+    return ctx.errores.size() == erroresPrevios;
+}
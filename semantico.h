@@ -0,0 +1,62 @@
+#ifndef SEMANTICO_H
+#define SEMANTICO_H
+
+#include <cstddef>
+#include <vector>
+#include "parser.h"
+#include "simbolos.h"
+
+// Tipos de los parametros y del retorno de una funcion
+struct Firma {
+    uint32_t primerParametro;   // indice en Semantica::tiposParametros
+    uint32_t parametros;
+    TipoId retorno;             // TIPO_VACIO si no tiene
+};
+
+// Lo que calculan las pasadas semanticas sobre ctx.ast. Se puede reusar
+// entre archivos: cada pasada lo pisa conservando la memoria.
+struct Semantica {
+    TablaSimbolos tabla;
+    // Por nodo: en N_VAR y N_LLAMADA, el N_DECLVAR, N_PARAMETRO o N_FUNCION
+    // que usan (NODO_NULO si no hay ninguno visible)
+    std::vector<NodoId> declaracion;
+    std::vector<Firma> firmas;          // de las funciones, en orden de declaracion
+    std::vector<TipoId> tiposParametros;
+    size_t declaraciones = 0;   // nombres declarados
+    size_t busquedas = 0;       // usos buscados en la tabla
+    size_t expresiones = 0;     // expresiones a las que se les calculo el tipo
+    size_t plegadas = 0;        // operaciones reemplazadas por su resultado (plegado.h)
+    size_t nodosEliminados = 0; // nodos que el plegado dejo fuera del arbol
+    size_t tareas = 0;          // en paralelo, las tareas en que se repartieron las funciones
+    std::vector<TablaSimbolos> tablasHilos;     // en paralelo, la copia de tabla de cada hilo
+};
+
+// Resolucion de nombres y verificacion de tipos. Las funciones y las
+// globales forman el alcance del programa y se ven en todo el archivo,
+// antes o despues de su declaracion. Cada funcion abre un alcance con sus
+// parametros, que comparte con las variables del comienzo de su bloque;
+// cada bloque de un if o un while abre otro, y sus variables ocultan a las
+// de afuera. Los usos sin declaracion visible, las declaraciones repetidas
+// en un mismo alcance, las llamadas a variables y las funciones usadas
+// como variables se registran en ctx.errores.
+// En el mismo recorrido se verifican los tipos (tipos.h, en ctx.tipos):
+// asignaciones, argumentos contra parametros, return contra el tipo de la
+// funcion, condiciones bool y operandos: int o char en la aritmetica y en
+// '<' '>' '<=' '>=', bool en 'and' 'or' 'not', el mismo tipo de los dos
+// lados de '=' y '<>'. int y char son intercambiables. Un operador con un
+// operando de otro tipo da un solo error: no genera otros en lo que lo
+// contiene. Un numeral que no entra en int (de 32 bits con signo) es un
+// error y su tipo es el de error.
+// Con hilos > 1 y un archivo grande, despues del alcance del programa,
+// que se declara en secuencia, las funciones se verifican en paralelo; los
+// errores son los mismos y en el mismo orden. Con ctx.maximoErrores quedan
+// los primeros que se encuentran en secuencia (el alcance del programa y
+// despues las funciones en orden), ordenados por posicion.
+// Supone un arbol sin errores sintacticos. Devuelve false si hubo errores.
+bool verificarPrograma(ParserContext& ctx, Semantica& semantica, unsigned hilos = 1);
+
+// Token que empieza en offset (los nodos guardan el offset de su token
+// principal), para ubicar en el los errores de un nodo
+size_t tokenEn(const ParserContext& ctx, uint32_t offset);
+
+#endif
@@ -0,0 +1,243 @@
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "servidor.h"
+
+// ============================================================
+// E/S del socket
+// ============================================================
+
+static bool leerTodo(int conexion, void* datos, size_t cantidad) {
+    char* p = (char*)datos;
+    while (cantidad > 0) {
+        ssize_t leidos = recv(conexion, p, cantidad, 0);
+        if (leidos < 0 && errno == EINTR) continue;
+        if (leidos <= 0) return false;
+        p += leidos;
+        cantidad -= (size_t)leidos;
+    }
+    return true;
+}
+
+// Un bloque "uint64 n, n bytes" de a lo sumo maximo bytes
+static bool leerBloque(int conexion, std::string& bloque, size_t maximo) {
+    uint64_t longitud;
+    if (!leerTodo(conexion, &longitud, sizeof(longitud)) || longitud > maximo) {
+        return false;
+    }
+    bloque.resize((size_t)longitud);
+    return leerTodo(conexion, &bloque[0], bloque.size());
+}
+
+static bool leerPedido(int conexion, Pedido& pedido) {
+    std::string argumentos;
+    if (!leerBloque(conexion, argumentos, MAXIMO_ARGUMENTOS_PEDIDO) ||
+        !leerBloque(conexion, pedido.entrada, MAXIMO_ENTRADA_PEDIDO)) {
+        return false;
+    }
+    // El directorio y cada argumento terminan en '\0'
+    if (argumentos.empty() || argumentos.back() != '\0') {
+        return false;
+    }
+    size_t inicio = 0;
+    while (inicio < argumentos.size()) {
+        size_t fin = argumentos.find('\0', inicio);
+        if (inicio == 0) {
+            pedido.directorio.assign(argumentos, 0, fin);
+        } else {
+            pedido.argumentos.emplace_back(argumentos, inicio, fin - inicio);
+        }
+        inicio = fin + 1;
+    }
+    return !pedido.directorio.empty();
+}
+
+// La respuesta en un solo sendmsg (mas si el socket no la toma entera).
+// MSG_NOSIGNAL: un cliente que se fue no debe terminar el servidor con SIGPIPE.
+static bool escribirRespuesta(int conexion, const Respuesta& respuesta) {
+    int32_t codigo = respuesta.codigo;
+    uint64_t longitudSalida = respuesta.salida.size();
+    uint64_t longitudErrores = respuesta.errores.size();
+    iovec partes[5] = {
+        {&codigo, sizeof(codigo)},
+        {&longitudSalida, sizeof(longitudSalida)},
+        {(void*)respuesta.salida.data(), respuesta.salida.size()},
+        {&longitudErrores, sizeof(longitudErrores)},
+        {(void*)respuesta.errores.data(), respuesta.errores.size()},
+    };
+    iovec* parte = partes;
+    size_t restantes = 5;
+    while (restantes > 0) {
+        msghdr mensaje = {};
+        mensaje.msg_iov = parte;
+        mensaje.msg_iovlen = restantes;
+        ssize_t escritos = sendmsg(conexion, &mensaje, MSG_NOSIGNAL);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos < 0) return false;
+        // Saltear lo que ya salio
+        size_t n = (size_t)escritos;
+        while (restantes > 0 && n >= parte->iov_len) {
+            n -= parte->iov_len;
+            parte++;
+            restantes--;
+        }
+        if (restantes > 0) {
+            parte->iov_base = (char*)parte->iov_base + n;
+            parte->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+// ============================================================
+// Conexiones
+// ============================================================
+
+// Conexiones aceptadas que esperan un trabajador
+struct ColaConexiones {
+    std::mutex mutex;
+    std::condition_variable hayConexion;
+    std::deque<int> conexiones;
+    bool cerrada = false;
+
+    void agregar(int conexion) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            conexiones.push_back(conexion);
+        }
+        hayConexion.notify_one();
+    }
+
+    void cerrar() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cerrada = true;
+        }
+        hayConexion.notify_all();
+    }
+
+    // false cuando se cerro y no quedan conexiones
+    bool tomar(int& conexion) {
+        std::unique_lock<std::mutex> lock(mutex);
+        hayConexion.wait(lock, [this]() { return cerrada || !conexiones.empty(); });
+        if (conexiones.empty()) return false;
+        conexion = conexiones.front();
+        conexiones.pop_front();
+        return true;
+    }
+};
+
+static void trabajador(ColaConexiones& cola, const AtenderPedido& atender) {
+    int conexion;
+    while (cola.tomar(conexion)) {
+        Pedido pedido;
+        if (leerPedido(conexion, pedido)) {
+            Respuesta respuesta;
+            atender(pedido, respuesta);
+            escribirRespuesta(conexion, respuesta);
+        }
+        close(conexion);
+    }
+}
+
+// SIGINT o SIGTERM: solo lo ve el hilo que acepta (los trabajadores los
+// bloquean), donde interrumpe accept
+static volatile sig_atomic_t terminar = 0;
+
+static void pedirTerminar(int) {
+    terminar = 1;
+}
+
+// Un socket en ruta al que nadie atiende quedo de un servidor anterior
+static bool socketAbandonado(const std::string& ruta, const sockaddr_un& direccion) {
+    struct stat info;
+    if (stat(ruta.c_str(), &info) != 0 || !S_ISSOCK(info.st_mode)) {
+        return false;
+    }
+    int prueba = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    bool atendido = prueba >= 0 && connect(prueba, (const sockaddr*)&direccion,
+                                           sizeof(direccion)) == 0;
+    if (prueba >= 0) close(prueba);
+    return !atendido;
+}
+
+int ejecutarServidor(const std::string& ruta, unsigned hilos, const AtenderPedido& atender,
+                     std::ostream& errores) {
+    sockaddr_un direccion = {};
+    direccion.sun_family = AF_UNIX;
+    if (ruta.empty() || ruta.size() >= sizeof(direccion.sun_path)) {
+        errores << "Error: La ruta del socket debe tener entre 1 y "
+                << sizeof(direccion.sun_path) - 1 << " bytes" << std::endl;
+        return 1;
+    }
+    memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+
+    int escucha = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (escucha < 0) {
+        errores << "Error: No se pudo crear el socket: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    if (socketAbandonado(ruta, direccion)) {
+        unlink(ruta.c_str());
+    }
+    if (bind(escucha, (const sockaddr*)&direccion, sizeof(direccion)) != 0 ||
+        listen(escucha, SOMAXCONN) != 0) {
+        errores << "Error: No se pudo escuchar en '" << ruta << "': " << strerror(errno)
+                << std::endl;
+        close(escucha);
+        return 1;
+    }
+
+    // Sin SA_RESTART, para que la senal interrumpa accept
+    struct sigaction accion = {};
+    accion.sa_handler = pedirTerminar;
+    sigemptyset(&accion.sa_mask);
+    sigaction(SIGINT, &accion, nullptr);
+    sigaction(SIGTERM, &accion, nullptr);
+
+    // Los trabajadores heredan la mascara con las dos senales bloqueadas
+    sigset_t senales, anteriores;
+    sigemptyset(&senales);
+    sigaddset(&senales, SIGINT);
+    sigaddset(&senales, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &senales, &anteriores);
+    ColaConexiones cola;
+    std::vector<std::thread> trabajadores;
+    for (unsigned h = 0; h < hilos; h++) {
+        trabajadores.emplace_back(trabajador, std::ref(cola), std::cref(atender));
+    }
+    pthread_sigmask(SIG_SETMASK, &anteriores, nullptr);
+
+    // Un cliente que deja de mandar su pedido no debe retener al trabajador
+    timeval espera = {SEGUNDOS_ESPERA_PEDIDO, 0};
+    while (!terminar) {
+        int conexion = accept4(escucha, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conexion < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            errores << "Error: Fallo accept: " << strerror(errno) << std::endl;
+            break;
+        }
+        setsockopt(conexion, SOL_SOCKET, SO_RCVTIMEO, &espera, sizeof(espera));
+        cola.agregar(conexion);
+    }
+
+    close(escucha);
+    unlink(ruta.c_str());
+    cola.cerrar();
+    for (std::thread& t : trabajadores) {
+        t.join();
+    }
+    return terminar ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Modo servidor (--servidor=ruta): un proceso ya cargado escucha en un
+// socket Unix y corre cada invocacion que le pide un cliente (cliente.c)
+// como si fuera ./parser con esos argumentos en el directorio del cliente,
+// y le devuelve la salida y el codigo de salida. Asi los archivos chicos no
+// pagan el arranque del proceso en cada analisis.
+//
+// Protocolo, una invocacion por conexion, enteros en el orden de bytes del
+// equipo (el socket es local):
+//   pedido:    uint64 n, n bytes: el directorio y los argumentos, cada uno
+//              terminado en '\0'; uint64 m, m bytes: la entrada estandar
+//              (vacia si ningun argumento es '-' ni --stdin)
+//   respuesta: int32 codigo; uint64 n, n bytes de stdout; uint64 m, m bytes
+//              de stderr
+
+// Mas que esto en el directorio y los argumentos es un pedido invalido
+const size_t MAXIMO_ARGUMENTOS_PEDIDO = 16 * 1024 * 1024;
+// La entrada estandar de un pedido llega entera antes de analizarla
+const size_t MAXIMO_ENTRADA_PEDIDO = (size_t)4 * 1024 * 1024 * 1024 - 2;
+// Un cliente que no termina de mandar su pedido en este tiempo se descarta
+const int SEGUNDOS_ESPERA_PEDIDO = 30;
+
+struct Pedido {
+    std::string directorio;                 // de trabajo del cliente
+    std::vector<std::string> argumentos;    // sin el nombre del programa
+    std::string entrada;                    // su entrada estandar
+};
+
+struct Respuesta {
+    int codigo = 0;
+    std::string salida;
+    std::string errores;
+};
+
+typedef std::function<void(const Pedido&, Respuesta&)> AtenderPedido;
+
+// Escucha en ruta y atiende las conexiones con hilos trabajadores, cada uno
+// una conexion a la vez; atender se llama desde varios hilos a la vez. Si
+// en ruta quedo el socket de un servidor que ya no corre lo reemplaza.
+// Termina con SIGINT o SIGTERM despues de completar los pedidos en curso, y
+// borra el socket. Devuelve el codigo de salida del proceso.
+int ejecutarServidor(const std::string& ruta, unsigned hilos, const AtenderPedido& atender,
+                     std::ostream& errores);
+
+#endif
@@ -0,0 +1,35 @@
+#include "simbolos.h"
+
+void iniciarTabla(TablaSimbolos& tabla, size_t cantidadSimbolos) {
+    tabla.visible.assign(cantidadSimbolos, SIN_VINCULO);
+    tabla.vinculos.clear();
+    tabla.alcances.clear();
+}
+
+void abrirAlcance(TablaSimbolos& tabla) {
+    tabla.alcances.push_back((uint32_t)tabla.vinculos.size());
+}
+
+void cerrarAlcance(TablaSimbolos& tabla) {
+    uint32_t marca = tabla.alcances.back();
+    tabla.alcances.pop_back();
+    // De la ultima a la primera, asi cada nombre vuelve a lo que tenia
+    // antes de abrir el alcance
+    while (tabla.vinculos.size() > marca) {
+        const Vinculo& v = tabla.vinculos.back();
+        tabla.visible[v.nombre] = v.sombreado;
+        tabla.vinculos.pop_back();
+    }
+}
+
+bool declarar(TablaSimbolos& tabla, SimboloId nombre, ClaseSimbolo clase, NodoId declaracion,
+              uint32_t tipo) {
+    uint32_t anterior = tabla.visible[nombre];
+    uint32_t inicioAlcance = tabla.alcances.empty() ? 0 : tabla.alcances.back();
+    if (anterior != SIN_VINCULO && anterior >= inicioAlcance) {
+        return false;
+    }
+    tabla.visible[nombre] = (uint32_t)tabla.vinculos.size();
+    tabla.vinculos.push_back(Vinculo{nombre, (uint8_t)clase, declaracion, anterior, tipo});
+    return true;
+}
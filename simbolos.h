@@ -0,0 +1,60 @@
+#ifndef SIMBOLOS_H
+#define SIMBOLOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "interner.h"
+#include "ast.h"
+
+// Que declara un nombre
+enum ClaseSimbolo : uint8_t {
+    SIMBOLO_FUNCION,
+    SIMBOLO_GLOBAL,
+    SIMBOLO_PARAMETRO,
+    SIMBOLO_LOCAL
+};
+
+// TablaSimbolos::visible sin declaracion
+const uint32_t SIN_VINCULO = 0xFFFFFFFFu;
+
+// Una declaracion de un alcance abierto
+struct Vinculo {
+    SimboloId nombre;
+    uint8_t clase;          // ClaseSimbolo
+    NodoId declaracion;     // N_FUNCION, N_DECLVAR o N_PARAMETRO
+    uint32_t sombreado;     // el vinculo del mismo nombre que oculta, o SIN_VINCULO
+    uint32_t tipo;          // el TipoId de una variable; de una funcion, su Semantica::firmas
+};
+
+// Tabla de simbolos con alcances anidados. Los ids del interner son densos
+// (0..cantidad-1), asi que en vez de un hash la tabla de nombres visibles
+// es un arreglo indexado por SimboloId: cada busqueda es un acceso. Las
+// declaraciones de los alcances abiertos se apilan en vinculos, cada una
+// con el vinculo que oculta; cerrar un alcance desapila hasta la marca que
+// se guardo al abrirlo y restaura lo oculto, sin copiar ni recorrer nada
+// mas que lo que ese alcance declaro.
+struct TablaSimbolos {
+    std::vector<uint32_t> visible;      // por SimboloId: indice en vinculos, o SIN_VINCULO
+    std::vector<Vinculo> vinculos;
+    std::vector<uint32_t> alcances;     // vinculos.size() al abrir cada alcance
+};
+
+// Deja la tabla vacia para nombres en [0, cantidadSimbolos), conservando
+// la memoria reservada
+void iniciarTabla(TablaSimbolos& tabla, size_t cantidadSimbolos);
+void abrirAlcance(TablaSimbolos& tabla);
+void cerrarAlcance(TablaSimbolos& tabla);
+
+// Declara nombre en el alcance actual. Si ya estaba declarado en ese mismo
+// alcance no hace nada y devuelve false.
+bool declarar(TablaSimbolos& tabla, SimboloId nombre, ClaseSimbolo clase, NodoId declaracion,
+              uint32_t tipo);
+
+// La declaracion visible de nombre, o nullptr
+inline const Vinculo* buscar(const TablaSimbolos& tabla, SimboloId nombre) {
+    uint32_t i = tabla.visible[nombre];
+    return i == SIN_VINCULO ? nullptr : &tabla.vinculos[i];
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include "tipos.h"
+#include "tokens.h"
+
+void iniciarTipos(TablaTipos& tabla) {
+    tabla.tipos.clear();
+    for (TipoId t = 0; t < CANTIDAD_TIPOS_BASICOS; t++) {
+        tabla.tipos.push_back(Tipo{SIN_TIPO, SIN_TIPO, t, 0});
+    }
+}
+
+TipoId arregloDe(TablaTipos& tabla, TipoId elemento) {
+    TipoId t = tabla.tipos[elemento].arreglo;
+    if (t == SIN_TIPO) {
+        const Tipo& e = tabla.tipos[elemento];
+        Tipo nuevo{elemento, SIN_TIPO, e.base, e.dimensiones + 1};
+        t = (TipoId)tabla.tipos.size();
+        tabla.tipos.push_back(nuevo);
+        tabla.tipos[elemento].arreglo = t;
+    }
+    return t;
+}
+
+TipoId tipoDe(TablaTipos& tabla, TipoId base, uint32_t dimensiones) {
+    TipoId t = base;
+    for (uint32_t i = 0; i < dimensiones; i++) {
+        t = arregloDe(tabla, t);
+    }
+    return t;
+}
+
+TipoId tipoBasico(int token) {
+    switch (token) {
+        case T_INT: return TIPO_INT;
+        case T_BOOL: return TIPO_BOOL;
+        case T_CHAR: return TIPO_CHAR;
+        case T_STRING: return TIPO_STRING;
+        default: return TIPO_ERROR;
+    }
+}
+
+static const char* const NOMBRES_BASICOS[CANTIDAD_TIPOS_BASICOS] = {
+    "?", "(ninguno)", "int", "bool", "char", "string"
+};
+
+void escribirTipo(const TablaTipos& tabla, TipoId t, std::string& salida) {
+    const Tipo& tipo = tabla.tipos[t];
+    for (uint32_t i = 0; i < tipo.dimensiones; i++) {
+        salida += "[]";
+    }
+    salida += NOMBRES_BASICOS[tipo.base];
+}
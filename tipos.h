@@ -0,0 +1,71 @@
+#ifndef TIPOS_H
+#define TIPOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Identificador de un tipo en TablaTipos. Cada tipo distinto tiene un solo
+// id, asi que comparar dos tipos (por ejemplo [][]int con [][]int) es
+// comparar dos enteros.
+typedef uint32_t TipoId;
+
+// Ids fijos: los tipos basicos y los dos especiales
+enum : TipoId {
+    TIPO_ERROR,         // de una expresion que ya tuvo un error: se acepta en todo lugar
+    TIPO_VACIO,         // de una llamada a una funcion sin tipo de retorno
+    TIPO_INT,
+    TIPO_BOOL,
+    TIPO_CHAR,
+    TIPO_STRING,
+    CANTIDAD_TIPOS_BASICOS
+};
+
+const TipoId SIN_TIPO = 0xFFFFFFFFu;
+
+struct Tipo {
+    TipoId elemento;        // en un arreglo, el tipo de sus elementos; si no, SIN_TIPO
+    TipoId arreglo;         // el tipo []este, si ya se creo; si no, SIN_TIPO
+    TipoId base;            // el tipo basico despues de todos los '[]'
+    uint32_t dimensiones;   // cantidad de '[]'
+};
+
+// Tipos unicos (hash consing). El unico constructor de Mini-0 es el
+// arreglo y cada tipo tiene a lo sumo un tipo arreglo de si mismo, asi que
+// la tabla de consing es Tipo::arreglo: buscar o crear []t es mirar un
+// campo de t, sin hash.
+struct TablaTipos {
+    std::vector<Tipo> tipos;
+};
+
+// Deja solo los tipos basicos, conservando la memoria reservada
+void iniciarTipos(TablaTipos& tabla);
+
+// El id de []elemento, creandolo si es nuevo
+TipoId arregloDe(TablaTipos& tabla, TipoId elemento);
+
+// El id de dimensiones veces '[]' delante de base
+TipoId tipoDe(TablaTipos& tabla, TipoId base, uint32_t dimensiones);
+
+// Tipo basico de un token de tipobase (T_INT, T_BOOL, T_CHAR, T_STRING);
+// TIPO_ERROR para cualquier otro
+TipoId tipoBasico(int token);
+
+inline bool esArreglo(const TablaTipos& tabla, TipoId t) {
+    return tabla.tipos[t].elemento != SIN_TIPO;
+}
+
+inline TipoId elementoDe(const TablaTipos& tabla, TipoId t) {
+    return tabla.tipos[t].elemento;
+}
+
+// int y char son intercambiables en la aritmetica y en las asignaciones
+inline bool esNumerico(TipoId t) {
+    return t == TIPO_INT || t == TIPO_CHAR;
+}
+
+// Agrega a salida el tipo como se escribe en Mini-0 ([]int, [][]char...)
+void escribirTipo(const TablaTipos& tabla, TipoId t, std::string& salida);
+
+#endif
@@ -0,0 +1,45 @@
+#include "tokenbuffer.h"
+#include "tokens.h"
+
+void TokenBuffer::limpiar() {
+    tipos.clear();
+    offsets.clear();
+    longitudes.clear();
+    valores.clear();
+    fuente = nullptr;
+    longitudFuente = 0;
+}
+
+void TokenBuffer::reservar(size_t longitudFuente) {
+    // Estimacion gruesa de un token cada 3 bytes para no realocar
+    size_t estimado = longitudFuente / 3 + 1;
+    tipos.reserve(estimado);
+    offsets.reserve(estimado);
+    longitudes.reserve(estimado);
+    valores.reserve(estimado);
+}
+
+void tokenizar(TokenBuffer& tokens, Interner& interner, char* fuente, size_t longitud) {
+    tokens.limpiar();
+    tokens.fuente = fuente;
+    tokens.longitudFuente = longitud;
+    tokens.reservar(longitud);
+
+    LexerEstado estado;
+    estado.interner = &interner;
+    yyscan_t scanner = lexerDesdeMemoria(fuente, longitud, &estado);
+
+    int token;
+    do {
+        token = yylex(scanner);
+        uint32_t valor = 0;
+        if (token == T_LITNUMERAL) {
+            valor = (uint32_t)estado.valor.num;
+        } else if (token == T_ID || token == T_LITSTRING) {
+            valor = estado.valor.sym;
+        }
+        tokens.agregar(token, estado.offset, estado.longitud, valor);
+    } while (token != T_EOF);
+
+    yylex_destroy(scanner);
+}
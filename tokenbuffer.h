@@ -0,0 +1,41 @@
+#ifndef TOKENBUFFER_H
+#define TOKENBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Interner;
+
+// Todos los tokens del archivo en arreglos paralelos. El lexer se corre
+// una sola vez antes del parser, y el parser avanza un indice sobre estos
+// arreglos en lugar de llamar a yylex() en cada match().
+struct TokenBuffer {
+    std::vector<uint8_t> tipos;        // valor de Tokens o caracter ASCII
+    std::vector<uint32_t> offsets;     // byte de inicio del lexema en la fuente
+    std::vector<uint32_t> longitudes;  // bytes del lexema
+    std::vector<uint32_t> valores;     // numero (T_LITNUMERAL) o SimboloId
+    const char* fuente;                // texto al que apuntan los offsets
+    size_t longitudFuente;             // bytes de fuente (las lineas se cuentan ahi)
+
+    size_t cantidad() const { return tipos.size(); }
+    void limpiar();
+    // Reserva lugar para los tokens estimados de una fuente de esa longitud
+    void reservar(size_t longitudFuente);
+
+    void agregar(int tipo, uint32_t offset, uint32_t longitud, uint32_t valor) {
+        tipos.push_back((uint8_t)tipo);
+        offsets.push_back(offset);
+        longitudes.push_back(longitud);
+        valores.push_back(valor);
+    }
+};
+
+// Corre el lexer sobre la fuente ya cargada (terminada en dos '\0', ver
+// fuente.h) hasta T_EOF inclusive: el ultimo token siempre es T_EOF, sin
+// lexema y ubicado al final del token anterior.
+// Usa un scanner propio, asi que puede correr en paralelo con otros
+// archivos siempre que cada uno tenga su TokenBuffer y su Interner.
+void tokenizar(TokenBuffer& tokens, Interner& interner, char* fuente, size_t longitud);
+
+#endif
@@ -1,4 +0,0 @@
-#include "tokens.h"
-
-YYSTYPE yylval;
-// tokenLinea se define en mini.l
\ No newline at end of file
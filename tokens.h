@@ -2,13 +2,17 @@
 #define TOKENS_H
 
 #include <cstdio>
+#include <cstdint>
+#include <cstring>
 
 enum Tokens {
     // Fin de archivo
     T_EOF = 0,
     
     // Salto de línea (MUY IMPORTANTE en Mini-0)
-    T_NL = 258,
+    // Empieza en 128 (despues de los caracteres ASCII que devuelve el
+    // lexer) para que todo token quepa en un uint8_t (ver tokenbuffer.h)
+    T_NL = 128,
     
     // Palabras reservadas
     T_IF,
@@ -43,16 +47,115 @@ enum Tokens {
     T_ERROR
 };
 
-extern int yylineno;
-extern char* yytext;
-extern FILE* yyin;
-extern int tokenLinea;
+static_assert(T_ERROR < 256, "los tokens deben caber en un uint8_t");
+
+// ============================================================
+// Palabras reservadas
+// ============================================================
+// El lexer reconoce palabras reservadas e identificadores con una sola
+// regla y despues consulta esta tabla. El hash usa el primer y el ultimo
+// caracter y la longitud; los multiplicadores se buscan en tiempo de
+// compilacion para que no haya colisiones entre las palabras reservadas.
+
+struct PalabraReservada {
+    const char* texto;
+    size_t longitud;
+    int token;
+};
+
+constexpr PalabraReservada PALABRAS_RESERVADAS[] = {
+    {"if", 2, T_IF},         {"else", 4, T_ELSE},     {"end", 3, T_END},
+    {"while", 5, T_WHILE},   {"loop", 4, T_LOOP},     {"fun", 3, T_FUN},
+    {"return", 6, T_RETURN}, {"new", 3, T_NEW},       {"string", 6, T_STRING},
+    {"int", 3, T_INT},       {"char", 4, T_CHAR},     {"bool", 4, T_BOOL},
+    {"true", 4, T_TRUE},     {"false", 5, T_FALSE},   {"and", 3, T_AND},
+    {"or", 2, T_OR},         {"not", 3, T_NOT},
+};
+
+constexpr size_t CANTIDAD_PALABRAS = sizeof(PALABRAS_RESERVADAS) / sizeof(PALABRAS_RESERVADAS[0]);
+constexpr unsigned TAMANO_HASH_PALABRAS = 32;     // potencia de 2
+constexpr size_t LONGITUD_MIN_PALABRA = 2;
+constexpr size_t LONGITUD_MAX_PALABRA = 6;
+
+constexpr unsigned hashPalabra(unsigned char primero, unsigned char ultimo, size_t longitud,
+                               unsigned a, unsigned b) {
+    return (primero * a + ultimo * b + (unsigned)longitud) & (TAMANO_HASH_PALABRAS - 1);
+}
+
+struct TablaPalabras {
+    unsigned a = 0, b = 0;
+    signed char indice[TAMANO_HASH_PALABRAS] = {};  // -1 = ranura vacia
+};
+
+// Primeros multiplicadores (a, b) sin colisiones y la tabla resultante
+constexpr TablaPalabras construirTablaPalabras() {
+    for (unsigned a = 1; a < 64; a++) {
+        for (unsigned b = 1; b < 64; b++) {
+            TablaPalabras tabla;
+            tabla.a = a;
+            tabla.b = b;
+            for (unsigned i = 0; i < TAMANO_HASH_PALABRAS; i++) tabla.indice[i] = -1;
+            bool perfecto = true;
+            for (size_t i = 0; i < CANTIDAD_PALABRAS && perfecto; i++) {
+                const PalabraReservada& p = PALABRAS_RESERVADAS[i];
+                unsigned h = hashPalabra(p.texto[0], p.texto[p.longitud - 1], p.longitud, a, b);
+                perfecto = tabla.indice[h] < 0;
+                tabla.indice[h] = (signed char)i;
+            }
+            if (perfecto) return tabla;
+        }
+    }
+    return TablaPalabras();
+}
+
+constexpr TablaPalabras TABLA_PALABRAS = construirTablaPalabras();
+static_assert(TABLA_PALABRAS.a != 0, "no hay hash perfecto para las palabras reservadas");
+
+// Token de la palabra reservada con ese texto, o T_ID si no es una
+inline int buscarPalabraReservada(const char* texto, size_t longitud) {
+    if (longitud < LONGITUD_MIN_PALABRA || longitud > LONGITUD_MAX_PALABRA) {
+        return T_ID;
+    }
+    unsigned h = hashPalabra((unsigned char)texto[0], (unsigned char)texto[longitud - 1],
+                             longitud, TABLA_PALABRAS.a, TABLA_PALABRAS.b);
+    int i = TABLA_PALABRAS.indice[h];
+    if (i < 0 || PALABRAS_RESERVADAS[i].longitud != longitud ||
+        memcmp(PALABRAS_RESERVADAS[i].texto, texto, longitud) != 0) {
+        return T_ID;
+    }
+    return PALABRAS_RESERVADAS[i].token;
+}
+
+class Interner;
 
 typedef union {
     int num;
-    char* str;
+    uint32_t sym;   // T_ID / T_LITSTRING: id en LexerEstado::interner
 } YYSTYPE;
 
-extern YYSTYPE yylval;
+// Estado que el lexer comparte con quien lo llama (yyextra del scanner
+// reentrante). Describe el ultimo token devuelto por yylex().
+struct LexerEstado {
+    YYSTYPE valor;
+    uint32_t offset;        // byte de inicio del ultimo token
+    uint32_t longitud;      // bytes del ultimo token
+    uint32_t posicion;      // bytes consumidos del buffer actual
+    uint32_t finToken;      // fin del ultimo token devuelto (offset de T_EOF)
+    Interner* interner;     // donde se internan identificadores y strings
+};
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+// Definidas en mini.l (scanner reentrante de flex)
+int yylex(yyscan_t yyscanner);
+int yylex_destroy(yyscan_t yyscanner);
+
+// Crea un scanner sobre un buffer en memoria (terminado en dos '\0')
+yyscan_t lexerDesdeMemoria(char* datos, size_t longitud, LexerEstado* estado);
+// Deja el buffer intacto si se abandona el scanner antes de T_EOF
+void restaurarBuffer(yyscan_t scanner);
 
 #endif
\ No newline at end of file